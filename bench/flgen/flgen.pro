@@ -0,0 +1,14 @@
+QT       += core
+QT       -= gui
+
+TARGET = flgen
+CONFIG   += console c++14
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += main.cpp \
+    generator.cpp
+
+HEADERS += \
+    generator.h
@@ -0,0 +1,185 @@
+#include "generator.h"
+
+namespace {
+
+class Generator {
+    const GeneratorOptions & o;
+    QByteArray doc;
+    quint32 state;
+    int serial = 0;
+public:
+    explicit Generator(const GeneratorOptions & options) : o(options), state(options.seed ? options.seed : 1) {}
+
+    QByteArray run() {
+        doc += "# data file for the Fltk User Interface Designer (fluid)\n"
+               "version 1.0303\n"
+               "header_name {.h}\n"
+               "code_name {.cxx}\n"
+               "class Synthetic {open\n} {\n"
+               "  Function {Synthetic()} {open\n  } {\n"
+               "    Fl_Window window {\n"
+               "      label {Synthetic window} open\n"
+               "      xywh {0 0 1024 768} type Double visible\n"
+               "    } {\n";
+        group(o.depth, o.widgets, 3, false);
+        doc += "    }\n  }\n}\n";
+        return doc;
+    }
+
+private:
+    quint32 random() {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    int random(int n) { return int(random() % quint32(n)); }
+
+    void indent(int level) { doc += QByteArray(2 * level, ' '); }
+
+    void xywh() {
+        doc += "xywh {" + QByteArray::number(random(900)) + ' ' + QByteArray::number(random(700))
+                + ' ' + QByteArray::number(20 + random(200)) + ' ' + QByteArray::number(20 + random(40)) + '}';
+    }
+
+    void label(const char * stem) {
+        doc += "label {" + QByteArray(stem) + ' ' + QByteArray::number(serial);
+        static const char * const escapes[] = { "\\x41", "\\101", "\\{", "\\}", "\\\\", "\\ " };
+        for (int i = 0; i < o.escapes; ++i) doc += escapes[random(6)];
+        doc += '}';
+    }
+
+    void callback(int level) {
+        if (o.callbackLines <= 0) return;
+        doc += '\n';
+        indent(level);
+        doc += "callback {";
+        for (int i = 0; i < o.callbackLines; ++i) {
+            switch (i % 4) {
+            case 0: doc += "if (o->value() > " + QByteArray::number(random(100)) + ") {\n"; break;
+            case 1: doc += "  # a comment with a stray } brace\n"; break;
+            case 2: doc += "  update(o, \"text {with braces}\", '\\\\n');\n"; break;
+            default: doc += "} else { other(); }\n"; break;
+            }
+        }
+        // close the if statement left open by a partial pattern
+        if (o.callbackLines % 4) doc += "}";
+        doc += '}';
+    }
+
+    /// Emits the header of an item; the attributes are left open
+    void item(int level, const char * class_) {
+        ++serial;
+        indent(level);
+        doc += QByteArray(class_) + ' ' + QByteArray(class_).toLower() + '_' + QByteArray::number(serial) + " {\n";
+        indent(level + 1);
+    }
+
+    void leaf(int level) {
+        switch (random(8)) {
+        case 0:
+            item(level, "Fl_Input");
+            label("Input");
+            doc += ' ';
+            xywh();
+            doc += random(2) ? " type Float" : " type Int";
+            doc += " minimum -100 maximum 100 step 0.5 value 1 labelsize 12 textsize 12";
+            callback(level + 1);
+            break;
+        case 1:
+            item(level, "Fl_Slider");
+            label("Slider");
+            doc += ' ';
+            xywh();
+            doc += " type {Horz Knob} align 4 minimum 0 maximum 10 step 0.1";
+            callback(level + 1);
+            break;
+        case 2:
+            item(level, "Fl_Value_Slider");
+            doc += "label Value ";
+            xywh();
+            doc += " type {Horz Knob} align 8 value 5";
+            break;
+        case 3:
+            item(level, "Fl_Button");
+            label("Button");
+            doc += ' ';
+            xywh();
+            callback(level + 1);
+            break;
+        case 4:
+            item(level, "Fl_Check_Button");
+            label("Check");
+            doc += ' ';
+            xywh();
+            doc += " down_box DOWN_BOX value 1";
+            break;
+        case 5:
+            item(level, "Fl_Box");
+            label("Box");
+            doc += ' ';
+            xywh();
+            doc += " align 20";
+            break;
+        case 6:
+            item(level, "Fl_Output");
+            label("Output");
+            doc += ' ';
+            xywh();
+            doc += " align 5";
+            break;
+        default:
+            item(level, "Fl_Choice");
+            label("Choice");
+            doc += ' ';
+            xywh();
+            doc += " down_box BORDER_BOX\n";
+            indent(level);
+            doc += "} {\n";
+            for (int i = 0; i < 3; ++i) {
+                item(level + 1, "MenuItem");
+                label("Item");
+                doc += " xywh {0 0 100 20}\n";
+                indent(level + 1);
+                doc += "}\n";
+            }
+            indent(level);
+            doc += "}\n";
+            return;
+        }
+        doc += '\n';
+        indent(level);
+        doc += "}\n";
+    }
+
+    /// Emits the children of a group, nesting groups down to the given depth
+    void group(int depth, int widgets, int level, bool tabs) {
+        if (depth <= 0 || widgets <= o.fanout) {
+            for (int i = 0; i < widgets; ++i) leaf(level);
+            return;
+        }
+        for (int g = 0; g < o.fanout; ++g) {
+            int const share = widgets / o.fanout + (g < widgets % o.fanout ? 1 : 0);
+            bool const childTabs = ! tabs && (depth + g) % 3 == 0;
+            item(level, childTabs ? "Fl_Tabs" : "Fl_Group");
+            label(childTabs ? "Tabs" : "Group");
+            doc += " open\n";
+            indent(level + 1);
+            xywh();
+            doc += '\n';
+            indent(level);
+            doc += "} {\n";
+            group(depth - 1, share, level + 1, childTabs);
+            indent(level);
+            doc += "}\n";
+        }
+    }
+};
+
+}
+
+QByteArray generateFluid(const GeneratorOptions & options)
+{
+    return Generator(options).run();
+}
@@ -0,0 +1,19 @@
+#ifndef FL2UI_GENERATOR_H
+#define FL2UI_GENERATOR_H
+
+#include <QByteArray>
+
+/// The size and shape of a synthetic FLUID document
+struct GeneratorOptions {
+    int widgets = 1000;         ///< leaf widgets in total
+    int depth = 3;              ///< nesting levels of Fl_Group and Fl_Tabs
+    int fanout = 4;             ///< groups in each group
+    int callbackLines = 4;      ///< lines in each callback body; 0 for none
+    int escapes = 1;            ///< escape sequences in each label
+    quint32 seed = 1;
+};
+
+/// Generates a FLUID document with one class, one function and one window
+QByteArray generateFluid(const GeneratorOptions & options);
+
+#endif // FL2UI_GENERATOR_H
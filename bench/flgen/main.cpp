@@ -0,0 +1,39 @@
+// Generates a synthetic FLUID document on the standard output.
+// Usage: flgen [--widgets N] [--depth N] [--fanout N] [--callback-lines N] [--escapes N] [--seed N]
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QFile>
+#include "generator.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCommandLineParser args;
+    args.setApplicationDescription("Generates a synthetic FLUID document on the standard output.");
+    args.addHelpOption();
+    GeneratorOptions o;
+    QCommandLineOption widgets("widgets", "Leaf widgets in total.", "n", QString::number(o.widgets));
+    QCommandLineOption depth("depth", "Nesting levels of Fl_Group and Fl_Tabs.", "n", QString::number(o.depth));
+    QCommandLineOption fanout("fanout", "Groups in each group.", "n", QString::number(o.fanout));
+    QCommandLineOption callbackLines("callback-lines", "Lines in each callback body.", "n", QString::number(o.callbackLines));
+    QCommandLineOption escapes("escapes", "Escape sequences in each label.", "n", QString::number(o.escapes));
+    QCommandLineOption seed("seed", "The random seed.", "n", QString::number(o.seed));
+    args.addOptions({ widgets, depth, fanout, callbackLines, escapes, seed });
+    args.process(a);
+
+    o.widgets = args.value(widgets).toInt();
+    o.depth = args.value(depth).toInt();
+    o.fanout = qMax(1, args.value(fanout).toInt());
+    o.callbackLines = args.value(callbackLines).toInt();
+    o.escapes = args.value(escapes).toInt();
+    o.seed = args.value(seed).toUInt();
+
+    QFile out;
+    if (! out.open(stdout, QIODevice::WriteOnly) || out.write(generateFluid(o)) < 0) {
+        QTextStream(stderr) << "Error writing the output" << endl;
+        return 2;
+    }
+    return 0;
+}
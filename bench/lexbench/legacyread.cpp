@@ -3,6 +3,10 @@
 // It is provided under the terms of the FLTK License, which
 // gives you some rights in addition to LGPL v.2
 
+// The QTextStream-based reader that the Lexer replaced, kept as the
+// benchmark baseline.
+
+#include "legacyread.h"
 #include <QTextStream>
 
 static bool isBrace(QChar c)
@@ -71,7 +75,7 @@ static QChar readQuoted(QTextStream & in)
     return QChar(c);
 }
 
-QString readWord(QTextStream & in, bool readBrace)
+QString legacyReadWord(QTextStream & in, bool readBrace)
 {
     QString result;
     QChar c;
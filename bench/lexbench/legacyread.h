@@ -0,0 +1,10 @@
+#ifndef FL2UI_LEGACYREAD_H
+#define FL2UI_LEGACYREAD_H
+
+#include <QString>
+
+class QTextStream;
+
+QString legacyReadWord(QTextStream & in, bool readBrace = false);
+
+#endif // FL2UI_LEGACYREAD_H
@@ -0,0 +1,19 @@
+QT       += core
+QT       -= gui
+
+TARGET = lexbench
+CONFIG   += console c++14
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../libfl2ui
+
+SOURCES += main.cpp \
+    legacyread.cpp \
+    ../../libfl2ui/arena.cpp \
+    ../../libfl2ui/read.cpp \
+    ../../libfl2ui/scan.cpp
+
+HEADERS += \
+    legacyread.h
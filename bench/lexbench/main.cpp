@@ -0,0 +1,102 @@
+// Compares the legacy QTextStream reader with the Lexer at each scan level.
+// Usage: lexbench [file.fl ...]
+// Without arguments, a synthetic FLUID document is used.
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include "legacyread.h"
+#include "read.h"
+#include "scan.h"
+
+QTextStream out(stdout);
+
+QByteArray synthetic()
+{
+    QByteArray widget =
+            "    Fl_Input input_%1 {\n"
+            "      label {Value \\x41:}\n"
+            "      callback {if (o->value()) {\n"
+            "  # a comment inside the callback\n"
+            "  do_something(o, \"text {with braces}\");\n"
+            "} else { other(); }}\n"
+            "      xywh {100 %1 120 25} type Float labelsize 12 textsize 12\n"
+            "      code0 {o->when(FL_WHEN_CHANGED);}\n"
+            "    }\n";
+    QByteArray doc = "# data file for the Fltk User Interface Designer (fluid)\n"
+                     "class Synthetic {open\n} {\n"
+                     "  Function {Synthetic()} {open\n  } {\n"
+                     "    Fl_Window window {open\n      xywh {0 0 800 600} type Double visible\n    } {\n";
+    for (int i = 0; i < 2000; ++i)
+        doc += QByteArray(widget).replace("%1", QByteArray::number(i));
+    doc += "    }\n  }\n}\n";
+    return doc;
+}
+
+/// Runs fn until at least 200ms elapse; returns the throughput in MB/s
+template <typename F> double measure(int bytes, int & tokens, F fn)
+{
+    QElapsedTimer timer;
+    timer.start();
+    int runs = 0;
+    do {
+        tokens = fn();
+        ++runs;
+    } while (timer.elapsed() < 200);
+    double const secs = timer.nsecsElapsed() / 1e9;
+    return double(bytes) * runs / secs / 1e6;
+}
+
+void bench(const QString & name, const QByteArray & data)
+{
+    out << name << ": " << data.size() << " bytes" << endl;
+    int tokens;
+    double rate = measure(data.size(), tokens, [&]{
+        QString input = QString::fromUtf8(data);
+        QTextStream in(&input);
+        int n = 0;
+        while (! legacyReadWord(in).isNull()) ++n;
+        return n;
+    });
+    out << "  legacy readWord     " << rate << " MB/s, " << tokens << " tokens" << endl;
+    for (int level = ScanScalar; level <= scanSupported(); ++level) {
+        scanSelect(ScanLevel(level));
+        QString const levelName = scanLevelName(ScanLevel(level));
+        rate = measure(data.size(), tokens, [&]{
+            Lexer in(data.constData(), data.size());
+            int n = 0;
+            while (! in.next().isNull()) ++n;
+            return n;
+        });
+        out << "  Lexer " << levelName.leftJustified(6) << " views   " << rate << " MB/s, " << tokens << " tokens" << endl;
+        rate = measure(data.size(), tokens, [&]{
+            Lexer in(data.constData(), data.size());
+            int n = 0;
+            while (! in.text(in.next()).isNull()) ++n;
+            return n;
+        });
+        out << "  Lexer " << levelName.leftJustified(6) << " strings " << rate << " MB/s, " << tokens << " tokens" << endl;
+    }
+    scanSelect(scanSupported());
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QStringList files = a.arguments().mid(1);
+    if (files.isEmpty()) {
+        bench("synthetic", synthetic());
+        return 0;
+    }
+    for (auto const & path : files) {
+        QFile f(path);
+        if (! f.open(QIODevice::ReadOnly)) {
+            out << "Cannot open input file " << path << endl;
+            return 1;
+        }
+        bench(path, f.readAll());
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+QT       += core network testlib
+QT       -= gui
+
+TARGET = parsebench
+CONFIG   += console c++14 testcase
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../flgen ../../cli
+
+# the uic whose headers the header backend is compared with
+UIC_PATH = $$[QT_HOST_BINS]/uic
+win32: UIC_PATH = $${UIC_PATH}.exe
+DEFINES += FL2UI_UIC=\\\"$$UIC_PATH\\\"
+
+include(../../libfl2ui/libfl2ui.pri)
+
+SOURCES += tst_parsebench.cpp \
+    ../flgen/generator.cpp
+
+HEADERS += \
+    ../flgen/generator.h
+
+# the server of the command line tool, which serveFiles runs
+SOURCES += \
+    ../../cli/files.cpp \
+    ../../cli/serve.cpp
+
+HEADERS += \
+    ../../cli/files.h \
+    ../../cli/serve.h
@@ -0,0 +1,793 @@
+// Benchmarks of the lexer, the parser handlers and whole conversions over
+// synthetic documents of several sizes, and checks that conversions agree
+// with each other however they're run, with uic and with live documents,
+// that deeply nested documents read, that the server converts files, and
+// that cached conversions count as much as fresh ones.
+// Usage: parsebench [QtTest options], e.g. parsebench -median 5 convert
+
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtEndian>
+#include <limits>
+#include <thread>
+#include "attributes.h"
+#include "batch.h"
+#include "cache.h"
+#include "convert.h"
+#include "generator.h"
+#include "live.h"
+#include "parser.h"
+#include "read.h"
+#include "serve.h"
+#include "stats.h"
+
+class ParseBench : public QObject {
+    Q_OBJECT
+private slots:
+    void readWord_data() { sizes(); }
+    void readWord();
+    void pAttributes();
+    void genLabel();
+    void convert_data() { sizes(); }
+    void convert();
+    void scaling_data();
+    void scaling();
+    void concurrent();
+    void parallel_data();
+    void parallel();
+    void header_data();
+    void header();
+    void deep();
+    void live_data();
+    void live();
+    void serveFiles();
+    void cachedStats();
+
+private:
+    void sizes();
+};
+
+/// A document of the given number of widgets
+static QByteArray document(int widgets)
+{
+    GeneratorOptions o;
+    o.widgets = widgets;
+    return generateFluid(o);
+}
+
+static void load(Source & source, const QByteArray & data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    source.read(buffer);
+}
+
+static int convertOnce(const Source & source)
+{
+    QBuffer out;
+    out.open(QIODevice::WriteOnly);
+    QString diagnostics;
+    return ::convert(source, out, diagnostics);
+}
+
+/// The outcome of a conversion
+struct Converted {
+    int rc = -1;
+    QByteArray output;
+    QString diagnostics;
+};
+
+static Converted convertData(const QByteArray & data, const ConvertOptions & options = ConvertOptions())
+{
+    Converted rv;
+    QBuffer out;
+    out.open(QIODevice::WriteOnly);
+    Source const source(data.constData(), data.size());
+    rv.rc = ::convert(source, out, rv.diagnostics, options);
+    rv.output = out.data();
+    return rv;
+}
+
+/// A document with every supported element, a few that aren't, and the
+/// constructs that are warned about
+static const char widgetsDocument[] = R"(# data file for the Fltk User Interface Designer (fluid)
+version 1.0303
+header_name {.h}
+code_name {.cxx}
+class Widgets {open
+} {
+  Function {Widgets()} {open
+  } {
+    Fl_Window window {
+      label {Every widget} open
+      xywh {100 100 640 480} type Double visible
+    } {
+      Fl_Tabs pages {
+        label Pages open
+        xywh {10 30 400 300} align 5
+      } {
+        Fl_Group general {
+          label General open
+          xywh {10 55 400 275}
+        } {
+          Fl_Input name_input {
+            label {Name:}
+            xywh {100 70 200 25} callback {changed(o);}
+          }
+          Fl_Input scale_input {
+            label {Scale:}
+            xywh {100 100 120 25} type Float minimum -10 maximum 10 step 0.25 value 1.5
+          }
+          Fl_Input count_input {
+            label {Count:}
+            xywh {100 130 120 25} type Int minimum 0 maximum 100 step 1 value 3
+          }
+          Fl_Choice mode {
+            label {Mode:} open
+            xywh {100 160 120 25} down_box BORDER_BOX
+          } {
+            MenuItem {} {
+              label Fast
+              xywh {0 0 100 20}
+            }
+            MenuItem {} {
+              label {Slow and "careful"}
+              xywh {0 0 100 20}
+            }
+          }
+        }
+        Fl_Group {} {
+          label {Caf)" "\xc3\xa9" R"(} open
+          xywh {10 55 400 275} hide
+        } {
+          Fl_Slider zoom {
+            label Zoom
+            xywh {100 70 200 20} type {Horz Knob} align 4 minimum 0 maximum 10 step 0.1
+          }
+          Fl_Slider {} {
+            label Pan
+            xywh {320 70 20 200} align 1
+          }
+          Fl_Value_Slider speed {
+            label Speed
+            xywh {100 100 200 20} type {Horz Knob} align 8 minimum 1 maximum 5 step 0.5 value 2
+          }
+          Fl_Value_Slider {} {
+            label Tilt
+            xywh {100 130 200 20} type {Vert Knob} align 2
+          }
+          Fl_Counter steps {
+            label Steps
+            xywh {100 160 100 25} align 4 minimum 1 maximum 9 step 1 value 4
+          }
+          MenuItem stray {
+            label Stray
+            xywh {0 0 100 20}
+          }
+        }
+      }
+      Fl_Box banner {
+        label {Two
+lines \\ with a backslash}
+        xywh {420 30 200 40} align 17
+      }
+      Fl_Box {} {
+        label {Odd alignment}
+        xywh {420 80 200 20} align 64
+      }
+      Fl_Button ok {
+        label OK
+        xywh {420 400 90 25}
+      }
+      Fl_Repeat_Button more {
+        label {More?}
+        xywh {520 400 90 25}
+      }
+      Fl_Light_Button light {
+        label Light
+        xywh {420 110 90 25}
+      }
+      Fl_Check_Button check {
+        label Check
+        xywh {420 140 90 25} down_box DOWN_BOX value 1
+      }
+      Fl_Round_Button radio {
+        label Radio
+        xywh {420 170 90 25} type Radio down_box ROUND_DOWN_BOX
+      }
+      Fl_Round_Button toggle {
+        label Toggle
+        xywh {420 200 90 25} down_box ROUND_DOWN_BOX
+      }
+      Fl_Round_Button {} {
+        label Other
+        xywh {420 230 90 25} type Toggle
+      }
+      Fl_Output result {
+        label {Result:}
+        xywh {100 340 200 25} align 5
+      }
+      Fl_Browser list {
+        label Items
+        xywh {100 370 200 60} type Multi align 1
+      }
+      Fl_Browser {} {
+        label Select
+        xywh {320 370 80 60} type Select
+      }
+      Fl_Text_Display log {
+        label Log
+        xywh {420 260 200 60} align 1
+      }
+      Fl_Text_Editor notes {
+        label Notes
+        xywh {420 330 200 60} align 4
+      }
+      Fl_Spinner unsupported {
+        label Spinner
+        xywh {10 440 60 25}
+      }
+    }
+  }
+}
+)";
+
+/// A widget that recovery skips, in the document with every widget
+static QByteArray brokenDocument()
+{
+    QByteArray rv = widgetsDocument;
+    rv.replace("xywh {420 400 90 25}", "xywh 420");
+    return rv;
+}
+
+/// Documents that convert cleanly, with warnings, past errors, or not at all
+static QVector<QByteArray> variedDocuments()
+{
+    QVector<QByteArray> rv;
+    for (quint32 seed = 1; seed <= 4; ++seed) {
+        GeneratorOptions o;
+        o.widgets = 200;
+        o.seed = seed;
+        rv << generateFluid(o);
+    }
+    QByteArray const widgets = widgetsDocument;
+    rv << widgets << brokenDocument();
+    // the end is missing
+    rv << widgets.left(widgets.size() / 2);
+    return rv;
+}
+
+static int readAll(const QByteArray & data)
+{
+    Lexer in(data.constData(), data.size());
+    int n = 0;
+    while (! ::readWord(in).isNull()) ++n;
+    return n;
+}
+
+/// The least time of a few runs of fn, in nanoseconds
+template <typename F> static qint64 fastest(F fn)
+{
+    qint64 best = std::numeric_limits<qint64>::max();
+    for (int i = 0; i < 5; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        fn();
+        best = qMin(best, timer.nsecsElapsed());
+    }
+    return best;
+}
+
+void ParseBench::sizes()
+{
+    QTest::addColumn<int>("widgets");
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void ParseBench::readWord()
+{
+    QFETCH(int, widgets);
+    QByteArray const data = document(widgets);
+    QVERIFY(readAll(data) > widgets);
+    QBENCHMARK {
+        readAll(data);
+    }
+}
+
+void ParseBench::pAttributes()
+{
+    QByteArray const item =
+            "label {Value \\x41:} xywh {100 200 120 25} type Float align 4 minimum -10 maximum 10"
+            " step 0.5 value 1 labelsize 12 textsize 12 when 1 callback {o->redraw();} open }\n";
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i) data += item;
+    Source source;
+    load(source, data);
+    ConvertOptions options;
+    QBENCHMARK {
+        Lexer in(source);
+        QString output, diagnostics;
+        QXmlStreamWriter writer(&output);
+        UiEmitter ui(writer);
+        Context c(in, ui, &diagnostics, options);
+        c.topLeft.push(QPoint(0, 0));
+        for (int i = 0; i < 1000; ++i) ::pAttributes(c);
+    }
+}
+
+void ParseBench::genLabel()
+{
+    Attributes attrs;
+    attrs.set(Attributes::Name, "input");
+    attrs.set(Attributes::Label, "Value:");
+    attrs.setXywh(QRect(100, 200, 120, 25), QPoint(0, 0));
+    ConvertOptions options;
+    Lexer in(nullptr, 0);
+    static const char * const aligns[] = { "4", "8", "1", "2", "5", "20", "0" };
+    QBENCHMARK {
+        QString output, diagnostics;
+        QXmlStreamWriter writer(&output);
+        UiEmitter ui(writer);
+        Context c(in, ui, &diagnostics, options);
+        for (int i = 0; i < 1000; ++i) {
+            Attributes a = attrs;
+            a.set(Attributes::Align, aligns[i % 7]);
+            ::genLabel(c, a);
+        }
+    }
+}
+
+void ParseBench::convert()
+{
+    QFETCH(int, widgets);
+    Source source;
+    load(source, document(widgets));
+    QCOMPARE(convertOnce(source), 0);
+    QBENCHMARK {
+        convertOnce(source);
+    }
+}
+
+void ParseBench::scaling_data()
+{
+    QTest::addColumn<bool>("whole");
+    QTest::newRow("readWord") << false;
+    QTest::newRow("convert") << true;
+}
+
+/// Flags superlinear growth: doubling the input must not much more than
+/// double the time
+void ParseBench::scaling()
+{
+    QFETCH(bool, whole);
+    qint64 previous = 0;
+    for (int widgets = 2000; widgets <= 32000; widgets *= 2) {
+        QByteArray const data = document(widgets);
+        Source source;
+        load(source, data);
+        qint64 const nsecs = whole ? fastest([&]{ convertOnce(source); })
+                                   : fastest([&]{ readAll(data); });
+        qDebug("%6d widgets, %8d bytes: %.2f ms", widgets, data.size(), nsecs / 1e6);
+        if (previous) {
+            double const ratio = double(nsecs) / previous;
+            QVERIFY2(ratio < 3.0, qPrintable(QString("the time grew %1 times from %2 to %3 widgets")
+                                              .arg(ratio, 0, 'f', 2).arg(widgets / 2).arg(widgets)));
+        }
+        previous = nsecs;
+    }
+}
+
+/// Runs many conversions at once, in each format and with recovery, and
+/// requires the same outcome as from each conversion on its own
+void ParseBench::concurrent()
+{
+    QVector<QByteArray> const documents = variedDocuments();
+    QVector<ConvertOptions> variants(3);
+    variants[1].format = ConvertOptions::Header;
+    variants[2].recover = true;
+    QVector<Converted> expected;
+    for (auto const & options : variants)
+        for (auto const & document : documents)
+            expected << convertData(document, options);
+
+    int const runs = 400;
+    QVector<Converted> results(runs);
+    runParallel(QVector<qint64>(runs, 1), qMax(4, QThread::idealThreadCount()), [&](int i){
+        // each thread reuses its buffers, as the batch conversion does
+        static thread_local Scratch scratch;
+        ConvertOptions options = variants.at(i % expected.size() / documents.size());
+        options.scratch = &scratch;
+        results[i] = convertData(documents.at(i % documents.size()), options);
+    });
+    for (int i = 0; i < runs; ++i) {
+        Converted const & e = expected.at(i % expected.size());
+        QCOMPARE(results.at(i).rc, e.rc);
+        QCOMPARE(results.at(i).output, e.output);
+        QCOMPARE(results.at(i).diagnostics, e.diagnostics);
+    }
+}
+
+void ParseBench::parallel_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("recover");
+    // the classes of concatenated documents have the same widget names,
+    // which the merge gives out again
+    QByteArray generated;
+    for (quint32 seed = 1; seed <= 6; ++seed) {
+        GeneratorOptions o;
+        o.widgets = 100 * int(seed);
+        o.seed = seed;
+        generated += generateFluid(o);
+    }
+    QByteArray const widgets = widgetsDocument;
+    QTest::newRow("generated") << generated << false;
+    QTest::newRow("warnings") << widgets + generated + widgets << false;
+    QTest::newRow("recovered") << generated + brokenDocument() + widgets << true;
+    QTest::newRow("unrecovered") << generated + brokenDocument() + widgets << false;
+    QTest::newRow("truncated") << generated + widgets.left(widgets.size() / 2) << false;
+}
+
+/// Converting the classes of a document on several threads and joining
+/// their output must give the same outcome as converting it on one
+void ParseBench::parallel()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, recover);
+    ConvertOptions options;
+    options.recover = recover;
+    Converted const serial = convertData(document, options);
+    for (int threads : { 2, 4, 16 }) {
+        options.threads = threads;
+        Converted const joined = convertData(document, options);
+        QCOMPARE(joined.rc, serial.rc);
+        QCOMPARE(joined.output, serial.output);
+        QCOMPARE(joined.diagnostics, serial.diagnostics);
+    }
+}
+
+void ParseBench::header_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<QString>("form");
+    GeneratorOptions o;
+    o.widgets = 300;
+    QTest::newRow("widgets") << QByteArray(widgetsDocument) << QString("Widgets");
+    QTest::newRow("generated") << generateFluid(o) << QString("Synthetic");
+}
+
+/// The part of a generated header past the comment at its top, which
+/// names the tool and the input
+static QByteArray withoutBanner(const QByteArray & header)
+{
+    return header.mid(header.indexOf("*/\n") + 3);
+}
+
+/// The header written for a single form must be the one uic generates
+/// from the .ui document written for it
+void ParseBench::header()
+{
+    QString const uic = FL2UI_UIC;
+    if (! QFileInfo(uic).isExecutable()) QSKIP("uic isn't available");
+    QFETCH(QByteArray, document);
+    QFETCH(QString, form);
+    ConvertOptions options;
+    Converted const ui = convertData(document, options);
+    options.format = ConvertOptions::Header;
+    Converted const header = convertData(document, options);
+    QCOMPARE(ui.rc, 0);
+    QCOMPARE(header.rc, 0);
+
+    // uic names the include guard after the files
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile file(dir.filePath(form + ".ui"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(ui.output), qint64(ui.output.size()));
+    file.close();
+    QProcess process;
+    process.setWorkingDirectory(dir.path());
+    process.start(uic, QStringList() << "-o" << "ui_" + form + ".h" << form + ".ui");
+    QVERIFY(process.waitForFinished());
+    QVERIFY2(process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0,
+             process.readAllStandardError().constData());
+    QFile generated(dir.filePath("ui_" + form + ".h"));
+    QVERIFY(generated.open(QIODevice::ReadOnly | QIODevice::Text));
+
+    QList<QByteArray> const expected = withoutBanner(generated.readAll()).split('\n');
+    QList<QByteArray> const actual = withoutBanner(header.output).split('\n');
+    for (int i = 0; i < qMin(expected.size(), actual.size()); ++i)
+        QVERIFY2(actual.at(i) == expected.at(i), qPrintable(QString("line %1: %2 instead of %3")
+                 .arg(i + 1).arg(QString::fromUtf8(actual.at(i)), QString::fromUtf8(expected.at(i)))));
+    QCOMPARE(actual.size(), expected.size());
+}
+
+/// A window with groups nested the given number deep, and a box in the
+/// innermost
+static QByteArray nestedDocument(int depth)
+{
+    QByteArray rv = "class Nested {open\n} {\n"
+                    "  Function {Nested()} {open\n  } {\n"
+                    "    Fl_Window window {\n      xywh {100 100 400 300} visible\n    } {\n";
+    for (int i = 0; i < depth; ++i) rv += "Fl_Group {} {open\nxywh {0 0 400 300}\n} {\n";
+    rv += "Fl_Box box {\nlabel Deep\nxywh {10 10 100 20}\n}\n";
+    for (int i = 0; i < depth; ++i) rv += "}\n";
+    rv += "    }\n  }\n}\n";
+    return rv;
+}
+
+/// Nesting as deep as the limit allows neither uses up the native stack nor
+/// goes past the limit, and the limits still stop a conversion
+void ParseBench::deep()
+{
+    int const depth = 100000;
+    QByteArray const data = nestedDocument(depth);
+    ConvertOptions options;
+    QCOMPARE(options.maxDepth, depth);
+
+    // the window holds a chain of groups that ends in the box
+    {
+        Lexer in(data.constData(), data.size());
+        QString output, diagnostics;
+        QXmlStreamWriter writer(&output);
+        UiEmitter ui(writer);
+        Context c(in, ui, &diagnostics, options);
+        ::pTop(c);
+        QCOMPARE(c.tree.size(), depth + 4);
+        int node = c.tree.at(c.tree.at(Tree::Root).firstChild).firstChild;
+        QCOMPARE(QByteArray(c.tree.at(node).element->name), QByteArray("Fl_Window"));
+        for (int i = 0; i < depth; ++i) {
+            node = c.tree.at(node).firstChild;
+            QVERIFY(node >= 0);
+            QCOMPARE(c.tree.at(node).next, -1);
+            QCOMPARE(QByteArray(c.tree.at(node).element->name), QByteArray("Fl_Group"));
+        }
+        node = c.tree.at(node).firstChild;
+        QCOMPARE(QByteArray(c.tree.at(node).element->name), QByteArray("Fl_Box"));
+        QCOMPARE(c.tree.at(node).attrs.text(Attributes::Name), QString("box"));
+        QVERIFY(diagnostics.isEmpty());
+    }
+
+    // the .ui document is indented as deep as the groups, so the header is
+    // checked instead: each group is created within the one around it
+    options.format = ConvertOptions::Header;
+    Converted const header = convertData(data, options);
+    QCOMPARE(header.rc, 0);
+    QVERIFY(header.diagnostics.isEmpty());
+    QString parent = "window";
+    int groups = 0;
+    for (auto const & line : header.output.split('\n')) {
+        int const created = line.indexOf(" = new QWidget(");
+        if (created < 0) continue;
+        QCOMPARE(line.mid(created + 15), QByteArray(parent.toUtf8() + ");"));
+        parent = QString::fromUtf8(line.left(created).trimmed());
+        ++groups;
+    }
+    QCOMPARE(groups, depth);
+    QVERIFY(header.output.contains(" = new QLabel(" + parent.toUtf8() + ");"));
+
+    // a level less, or fewer elements, is an error whether recovering or not
+    ConvertOptions shallow;
+    shallow.maxDepth = depth - 1;
+    Converted const tooDeep = convertData(data, shallow);
+    QCOMPARE(tooDeep.rc, 11);
+    QVERIFY(tooDeep.diagnostics.contains(QString("nested more than %1 deep").arg(depth - 1)));
+    for (bool recover : { false, true }) {
+        ConvertOptions few;
+        few.recover = recover;
+        few.maxElements = depth / 2;
+        QCOMPARE(convertData(data, few).rc, 11);
+    }
+}
+
+/// Writing the live document must give what converting its text afresh
+/// gives, with the same diagnostics; when the reading stopped at an error,
+/// neither writes it all
+static void compareWithFresh(LiveDocument & live, int rc, const ConvertOptions & options)
+{
+    Converted const fresh = convertData(live.text(), options);
+    QCOMPARE(rc, fresh.rc);
+    QBuffer out;
+    out.open(QIODevice::WriteOnly);
+    QCOMPARE(live.write(out), fresh.rc);
+    if (fresh.rc == 0 || fresh.rc == 5) QCOMPARE(out.data(), fresh.output);
+    QCOMPARE(live.diagnostics(), fresh.diagnostics);
+}
+
+void ParseBench::live_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("recover");
+    QTest::addColumn<bool>("warned");
+    // without the unknown element, reading the document gives no warnings
+    QByteArray const warned = widgetsDocument;
+    QByteArray clean = warned;
+    int const unknown = clean.indexOf("      Fl_Spinner");
+    clean.remove(unknown, clean.indexOf("      }\n", unknown) + 8 - unknown);
+    QTest::newRow("clean") << clean << false << false;
+    QTest::newRow("clean, recovering") << clean << true << false;
+    QTest::newRow("warned") << warned << false << true;
+    QTest::newRow("warned, recovering") << warned << true << true;
+}
+
+/// A sequence of edits to a live document, each of which must leave it as
+/// a fresh conversion of the edited text would be
+void ParseBench::live()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, recover);
+    QFETCH(bool, warned);
+    // each replaces the first occurrence of a text; the errors are within a
+    // group, which rereading recovers from, and at the top of the window
+    static const char * const edits[][2] = {
+        { "label Fast", "label Faster" },
+        { "xywh {100 70 200 25}", "xywh {110 75 200 25}" },
+        { "label Zoom", "label {Zoom in}" },
+        { "label OK", "label Okay" },
+        { "xywh {100 130 120 25} type", "xywh 100 type" },
+        { "xywh 100 type", "xywh {100 130 120 25} type" },
+        { "xywh {420 400 90 25}", "xywh 420" },
+        { "xywh 420", "xywh {420 400 90 25}" },
+        { "      Fl_Button ok {", "      Fl_Button extra {\n        label Extra\n"
+                                  "        xywh {420 430 90 25}\n      }\n      Fl_Button ok {" },
+        { "label Faster", "label Fast" },
+    };
+    ConvertOptions options;
+    options.recover = recover;
+    LiveDocument live(options);
+    compareWithFresh(live, live.open(document), options);
+    if (QTest::currentTestFailed()) return;
+    for (auto const & e : edits) {
+        int const offset = live.text().indexOf(e[0]);
+        QVERIFY(offset >= 0);
+        compareWithFresh(live, live.edit(offset, int(qstrlen(e[0])), e[1]), options);
+        if (QTest::currentTestFailed()) return;
+    }
+
+    // rereading a group again and again leaves the nodes it replaces
+    // behind, until the document is read as a whole; a document whose
+    // reading gave warnings is always read as a whole
+    int incremental = 0;
+    for (int i = 0; i < 20; ++i) {
+        bool const longer = i % 2 == 0;
+        QByteArray const from = longer ? "label General" : "label {General settings}";
+        QByteArray const to = longer ? "label {General settings}" : "label General";
+        int const offset = live.text().indexOf(from);
+        QVERIFY(offset >= 0);
+        compareWithFresh(live, live.edit(offset, from.size(), to), options);
+        if (QTest::currentTestFailed()) return;
+        if (live.wasIncremental()) ++incremental;
+    }
+    if (warned) {
+        QCOMPARE(incremental, 0);
+    }
+    else {
+        QVERIFY(incremental > 0);
+        QVERIFY(incremental < 20);
+    }
+}
+
+/// A request to the server, as a frame
+static QByteArray requestFrame(const QJsonObject & request)
+{
+    QByteArray const payload = QJsonDocument(request).toJson(QJsonDocument::Compact);
+    QByteArray rv(4, 0);
+    qToBigEndian(quint32(payload.size()), reinterpret_cast<uchar *>(rv.data()));
+    return rv + payload;
+}
+
+/// Reads bytes off the socket until the data has the size
+static bool readFully(QLocalSocket & socket, QByteArray & data, int size)
+{
+    while (data.size() < size) {
+        if (! socket.bytesAvailable() && ! socket.waitForReadyRead(30000)) return false;
+        data += socket.read(size - data.size());
+    }
+    return true;
+}
+
+/// The next response of the server; empty if none comes
+static QJsonObject readResponse(QLocalSocket & socket)
+{
+    QByteArray header, payload;
+    if (! readFully(socket, header, 4)) return QJsonObject();
+    quint32 const size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(header.constData()));
+    if (! readFully(socket, payload, int(size))) return QJsonObject();
+    return QJsonDocument::fromJson(payload).object();
+}
+
+/// The server must convert the files that requests name, which it maps
+/// while converting them, as it converts the content that requests carry
+void ParseBench::serveFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString const input = dir.filePath("widgets.fl");
+    QString const output = dir.filePath("widgets.ui");
+    QFile file(input);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(widgetsDocument);
+    file.close();
+
+    ServeOptions options;
+    options.socketName = QString("parsebench-%1").arg(QCoreApplication::applicationPid());
+    // ends the server should the client go missing
+    options.idleSeconds = 30;
+    QVector<QJsonObject> const requests = {
+        {{ "id", 1 }, { "input", input }},
+        {{ "id", 2 }, { "input", input }, { "output", output }},
+        {{ "id", 3 }, { "content", QString::fromUtf8(widgetsDocument) }},
+    };
+    QVector<QJsonObject> responses;
+    // the server runs the event loop of this thread, so the client has its own
+    std::thread client([&]{
+        QLocalSocket socket;
+        for (int i = 0; i < 100; ++i) {
+            socket.connectToServer(options.socketName);
+            if (socket.waitForConnected(1000)) break;
+            QThread::msleep(50);
+        }
+        if (socket.state() != QLocalSocket::ConnectedState) return;
+        for (auto const & request : requests) {
+            socket.write(requestFrame(request));
+            socket.waitForBytesWritten(30000);
+            responses << readResponse(socket);
+        }
+        socket.write(requestFrame({{ "command", "shutdown" }}));
+        socket.waitForBytesWritten(30000);
+    });
+    int const rc = ::serve(options);
+    client.join();
+    QCOMPARE(rc, 0);
+    QCOMPARE(responses.size(), requests.size());
+
+    Converted const expected = convertData(widgetsDocument);
+    QCOMPARE(expected.rc, 0);
+    for (int i = 0; i < responses.size(); ++i) {
+        QJsonObject const & response = responses.at(i);
+        QCOMPARE(response["id"].toInt(), i + 1);
+        QCOMPARE(response["status"].toInt(), expected.rc);
+        QCOMPARE(response["diagnostics"].toString(), expected.diagnostics);
+        if (! requests.at(i).contains("output"))
+            QCOMPARE(response["ui"].toString().toUtf8(), expected.output);
+    }
+    QFile written(output);
+    QVERIFY(written.open(QIODevice::ReadOnly));
+    QCOMPARE(written.readAll(), expected.output);
+}
+
+/// A conversion found in the cache must count what converting it counts,
+/// apart from the cache itself
+void ParseBench::cachedStats()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    Cache cache(dir.path(), 1024 * 1024);
+    Stats missed, hit;
+    ConvertOptions options;
+    options.cache = &cache;
+    options.stats = &missed;
+    Converted const first = convertData(widgetsDocument, options);
+    options.stats = &hit;
+    Converted const second = convertData(widgetsDocument, options);
+    QCOMPARE(missed.cacheMisses, qint64(1));
+    QCOMPARE(hit.cacheHits, qint64(1));
+    QCOMPARE(second.diagnostics, first.diagnostics);
+    QVERIFY(missed.warnings > 0);
+    QCOMPARE(hit.warnings, missed.warnings);
+    QCOMPARE(hit.files, missed.files);
+    QCOMPARE(hit.bytes, missed.bytes);
+}
+
+QTEST_GUILESS_MAIN(ParseBench)
+
+#include "tst_parsebench.moc"
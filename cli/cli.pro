@@ -0,0 +1,35 @@
+QT       += core network
+QT       -= gui
+
+TARGET = fl2ui
+CONFIG   += console c++14
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../libfl2ui
+DEPENDPATH += ../libfl2ui
+
+fl2ui_shared: DEFINES += FL2UI_SHARED
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../libfl2ui/release/ -lfl2ui
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../libfl2ui/debug/ -lfl2ui
+else: LIBS += -L$$OUT_PWD/../libfl2ui/ -lfl2ui
+
+!fl2ui_shared {
+    win32-g++:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../libfl2ui/release/libfl2ui.a
+    else:win32-g++:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../libfl2ui/debug/libfl2ui.a
+    else:win32:CONFIG(release, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../libfl2ui/release/fl2ui.lib
+    else:win32:CONFIG(debug, debug|release): PRE_TARGETDEPS += $$OUT_PWD/../libfl2ui/debug/fl2ui.lib
+    else: PRE_TARGETDEPS += $$OUT_PWD/../libfl2ui/libfl2ui.a
+}
+
+win32: LIBS += -lpsapi
+
+SOURCES += main.cpp \
+    files.cpp \
+    serve.cpp
+
+HEADERS += \
+    files.h \
+    serve.h
@@ -0,0 +1,200 @@
+#include "files.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QTextStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <cstring>
+#include "convert.h"
+#include "read.h"
+#include "trace.h"
+
+QString defaultOutPath(const QString & inPath, ConvertOptions::Format format)
+{
+    QFileInfo fi(inPath);
+    switch (format) {
+    case ConvertOptions::Header: return fi.path() + "/ui_" + fi.baseName() + ".h";
+    case ConvertOptions::Inventory: return fi.path() + "/" + fi.baseName() + ".inventory.json";
+    case ConvertOptions::Warnings: return fi.path() + "/" + fi.baseName() + ".warnings.txt";
+    default: return fi.path() + "/" + fi.baseName() + ".ui";
+    }
+}
+
+namespace {
+
+/// Compares the output with the existing file as it's written, and only
+/// starts replacing the file once they differ. Without comparing, the file
+/// is replaced with the output in any case.
+class ChangedFile : public QIODevice {
+    Q_DISABLE_COPY(ChangedFile)
+public:
+    explicit ChangedFile(const QString & path, bool compare = true) : m_old(path), m_new(path) {
+        m_changed = ! compare || ! m_old.open(QIODevice::ReadOnly | QIODevice::Text);
+        open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+    }
+    bool isSequential() const override { return true; }
+    /// Whether the output differs from the existing file so far
+    bool changed() const { return m_changed; }
+    /// Opens the new file; false if it can't be
+    bool start() {
+        return m_new.open(QIODevice::WriteOnly | QIODevice::Text) && copyMatched();
+    }
+    /// Replaces the file if the output differs; true when the file is up
+    /// to date
+    bool commit() {
+        // an existing file that goes on past the output differs as well
+        if (! m_changed && ! m_old.atEnd() && ! diverge()) return false;
+        return ! m_changed || m_new.commit();
+    }
+    void cancel() {
+        if (m_new.isOpen()) m_new.cancelWriting();
+    }
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char * data, qint64 len) override {
+        if (! m_changed) {
+            // output past the end of the existing file needn't be compared
+            if (m_matched + len <= m_old.size()) {
+                if (m_scratch.size() < len) m_scratch.resize(int(len));
+                qint64 const got = m_old.read(m_scratch.data(), len);
+                if (got == len && ! memcmp(data, m_scratch.constData(), size_t(len))) {
+                    m_matched += len;
+                    return len;
+                }
+            }
+            if (! diverge()) return -1;
+        }
+        return m_new.write(data, len) == len ? len : -1;
+    }
+private:
+    /// Switches to writing the new file, starting with the matched part
+    bool diverge() {
+        m_changed = true;
+        return m_new.isOpen() || start();
+    }
+    /// Writes the part of the existing file that matched the output so far
+    bool copyMatched() {
+        if (! m_matched) return true;
+        if (! m_old.seek(0)) return false;
+        for (qint64 left = m_matched; left > 0; ) {
+            qint64 const got = m_old.read(m_scratch.data(), qMin<qint64>(left, m_scratch.size()));
+            if (got <= 0 || m_new.write(m_scratch.constData(), got) != got) return false;
+            left -= got;
+        }
+        return true;
+    }
+    QFile m_old;
+    QSaveFile m_new;
+    QByteArray m_scratch;
+    qint64 m_matched = 0;
+    bool m_changed;
+};
+
+}
+
+/// Converts into the files, leaving each untouched when it already has the
+/// same contents if the options ask for it
+int convertTo(const Source & source, const QVector<OutFile> & outputs, QTextStream & log,
+              const ConvertOptions & options)
+{
+    QVector<ChangedFile *> files;
+    QVector<Output> devices;
+    int rc = 0;
+    for (auto const & o : outputs) {
+        files << new ChangedFile(o.path, options.onlyIfChanged);
+        if (files.last()->changed() && ! files.last()->start()) {
+            log << "Cannot open output file " << o.path << endl;
+            rc = 2;
+            break;
+        }
+        devices.append({ o.format, files.last() });
+    }
+    if (! rc) {
+        QString diagnostics;
+        rc = convert(source, devices, diagnostics, options);
+        log << diagnostics;
+    }
+    bool const abandoned = rc && rc != 5;
+    for (int i = 0; i < files.size(); ++i) {
+        ChangedFile & f = *files.at(i);
+        if (abandoned) {
+            // the conversion was abandoned; leave any previous output alone
+            f.cancel();
+        }
+        else if (! f.commit()) {
+            log << "Cannot finish output file " << outputs.at(i).path << endl;
+            f.cancel();
+            if (! rc) rc = 3;
+        }
+        else if (! f.changed()) {
+            log << "Unchanged " << outputs.at(i).path << endl;
+        }
+    }
+    qDeleteAll(files);
+    return rc;
+}
+
+/// Converts one file, logging the messages
+static void convertFile(FileResult & r, QTextStream & log, const ConvertOptions & options)
+{
+    QFile fIn(r.inPath);
+    if (! fIn.open(QIODevice::ReadOnly)) {
+        log << "Cannot open input file " << r.inPath << endl;
+        r.rc = 1;
+        return;
+    }
+    log << "Processing " << r.inPath << endl;
+    Source source;
+    QElapsedTimer timer;
+    timer.start();
+    if (! source.open(fIn)) {
+        log << "Error reading the input" << endl;
+        r.rc = 3;
+        return;
+    }
+    r.stats.nsecs[Stats::Read] += timer.nsecsElapsed();
+    r.rc = convertTo(source, r.outputs, log, options);
+}
+
+void convertFile(FileResult & r, ConvertOptions options)
+{
+    // each worker thread keeps its buffers from one file to the next
+    static thread_local Scratch scratch;
+    options.scratch = &scratch;
+    QTextStream log(&r.log);
+    if (options.stats) options.stats = &r.stats;
+    qint64 const start = options.trace ? options.trace->now() : 0;
+    convertFile(r, log, options);
+    if (options.trace)
+        options.trace->add({ "file", start, options.trace->now() - start, QJsonObject{{ "path", r.inPath }} });
+}
+
+/// Escapes a path for a Makefile rule
+static QString makeEscaped(const QString & path)
+{
+    QString rv;
+    for (QChar ch : QDir::fromNativeSeparators(path)) {
+        if (ch == ' ' || ch == '#') rv += '\\';
+        else if (ch == '$') rv += '$';
+        rv += ch;
+    }
+    return rv;
+}
+
+bool writeDepfile(const QString & path, const QVector<FileResult> & results)
+{
+    QString const converter = makeEscaped(QCoreApplication::applicationFilePath());
+    QSaveFile f(path);
+    if (! f.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream str(&f);
+    str.setCodec("UTF-8");
+    for (auto const & r : results)
+        if (r.rc == 0 || r.rc == 5)
+            for (auto const & o : r.outputs)
+                str << makeEscaped(o.path) << ": " << makeEscaped(r.inPath) << " " << converter << "\n";
+    str.flush();
+    return str.status() == QTextStream::Ok && f.commit();
+}
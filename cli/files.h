@@ -0,0 +1,53 @@
+#ifndef FL2UI_FILES_H
+#define FL2UI_FILES_H
+
+#include <QString>
+#include <QVector>
+#include "fl2ui.h"
+#include "stats.h"
+
+class QTextStream;
+class Source;
+
+/// A file written by a conversion
+struct OutFile {
+    ConvertOptions::Format format;
+    QString path;
+};
+
+/// The outcome of converting one file
+struct FileResult {
+    QString inPath;
+    QVector<OutFile> outputs;
+    QString log;
+    int rc = -1;
+    Stats stats;
+};
+
+/// The .ui file next to the input, the ui_*.h header that uic would
+/// generate from it, or the <input>.inventory.json or <input>.warnings.txt
+/// report
+QString defaultOutPath(const QString & inPath, ConvertOptions::Format format = ConvertOptions::Ui);
+
+/// Converts the source once into each of the files, which are replaced only
+/// when the conversion produced a document. Returns the conversion status.
+int convertTo(const Source & source, const QVector<OutFile> & outputs, QTextStream & log,
+              const ConvertOptions & options);
+
+/// Converts the source into the file at outPath in the format of the options
+inline int convertTo(const Source & source, const QString & outPath, QTextStream & log,
+                     const ConvertOptions & options)
+{
+    return convertTo(source, QVector<OutFile>{{ options.format, outPath }}, log, options);
+}
+
+/// Converts one file; messages go to the result's log rather than to stderr,
+/// so that files can be converted concurrently. When stats are collected,
+/// they go to the result's stats.
+void convertFile(FileResult & r, ConvertOptions options);
+
+/// Writes a Makefile rule for each output of the converted files that names
+/// its input and the converter as its prerequisites
+bool writeDepfile(const QString & path, const QVector<FileResult> & results);
+
+#endif // FL2UI_FILES_H
@@ -0,0 +1,414 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStringList>
+#include <QTextStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <climits>
+#include <cstdio>
+#include "batch.h"
+#include "cache.h"
+#include "census.h"
+#include "convert.h"
+#include "files.h"
+#include "read.h"
+#include "serve.h"
+#include "stats.h"
+#include "trace.h"
+
+QTextStream err(stderr);
+
+/// Reads input paths from a list file, one per line; "-" reads standard input
+bool readList(const QString & path, QStringList & files)
+{
+    QFile f;
+    if (path == "-") {
+        if (! f.open(stdin, QIODevice::ReadOnly | QIODevice::Text)) return false;
+    } else {
+        f.setFileName(path);
+        if (! f.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    }
+    QTextStream in(&f);
+    while (! in.atEnd()) {
+        QString const line = in.readLine().trimmed();
+        if (! line.isEmpty() && ! line.startsWith('#')) files << line;
+    }
+    return true;
+}
+
+/// Reads the outputs given as <kind>[=<file>] with --emit; the path is empty
+/// when no file is named
+bool readEmits(const QStringList & values, QVector<OutFile> & emits)
+{
+    static const char * const kinds[] = { "ui", "header", "inventory", "warnings" };
+    int const kindCount = int(sizeof(kinds) / sizeof(kinds[0]));
+    for (auto const & value : values) {
+        int const eq = value.indexOf('=');
+        QString const kind = value.left(eq);
+        QString const path = eq < 0 ? QString() : value.mid(eq + 1);
+        int i = 0;
+        while (i < kindCount && kind != kinds[i]) ++i;
+        if (i == kindCount || (eq >= 0 && path.isEmpty())) {
+            err << "Invalid output " << value << "; expected ui, header, inventory or warnings,"
+                << " optionally followed by =<file>" << endl;
+            return false;
+        }
+        emits.append({ ConvertOptions::Format(i), path });
+    }
+    return true;
+}
+
+/// The files to write for the input: those given with --emit, next to the
+/// input unless named, or else the default output
+QVector<OutFile> outFiles(const QString & inPath, const QVector<OutFile> & emits,
+                          ConvertOptions::Format format)
+{
+    if (emits.isEmpty()) return QVector<OutFile>{{ format, defaultOutPath(inPath, format) }};
+    QVector<OutFile> rv = emits;
+    for (auto & o : rv)
+        if (o.path.isEmpty()) o.path = defaultOutPath(inPath, o.format);
+    return rv;
+}
+
+/// Converts all files, each to its default output paths, and reports the
+/// outcome of each. Writes the dependencies of the outputs to depfile if
+/// it's set. Returns the status of the first file that failed.
+int convertBatch(const QStringList & files, int jobs, const ConvertOptions & options,
+                 const QVector<OutFile> & emits, const QString & depfile)
+{
+    QVector<FileResult> results(files.size());
+    QVector<qint64> sizes(files.size());
+    for (int i = 0; i < files.size(); ++i) {
+        results[i].inPath = files.at(i);
+        results[i].outputs = outFiles(files.at(i), emits, options.format);
+        sizes[i] = QFileInfo(files.at(i)).size();
+    }
+    // threads left over convert the classes of a file in parallel
+    ConvertOptions fileOptions = options;
+    fileOptions.threads = qMax(1, jobs / qMax(1, files.size()));
+    runParallel(sizes, jobs, [&](int i){ convertFile(results[i], fileOptions); });
+    if (options.stats)
+        for (auto const & r : results) options.stats->add(r.stats);
+
+    int rc = 0, failed = 0;
+    for (auto const & r : results) {
+        err << r.log;
+        if (r.rc) {
+            ++failed;
+            if (! rc) rc = r.rc;
+        }
+    }
+    err << "\nSummary:\n";
+    for (auto const & r : results)
+        err << (r.rc == 0 ? QString("ok ") : r.rc == 5 ? QString("recovered ") : QString("FAILED (%1) ").arg(r.rc))
+            << r.inPath << "\n";
+    err << results.size() - failed << " converted, " << failed << " failed" << endl;
+    if (! depfile.isEmpty() && ! writeDepfile(depfile, results)) {
+        err << "Cannot write the depfile " << depfile << endl;
+        if (! rc) rc = 2;
+    }
+    return rc;
+}
+
+/// Takes a census of every .fl file under dir on the given number of threads
+/// and writes the report to standard output
+int scanTree(const QString & dir, int jobs)
+{
+    if (! QFileInfo(dir).isDir()) {
+        err << "Cannot scan " << dir << ": not a directory" << endl;
+        return 1;
+    }
+    QStringList files;
+    QDirIterator it(dir, QStringList() << "*.fl", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) files << it.next();
+    // the report lists the files in a stable order
+    files.sort();
+    QVector<qint64> sizes(files.size());
+    for (int i = 0; i < files.size(); ++i) sizes[i] = QFileInfo(files.at(i)).size();
+
+    QVector<Census> censuses(files.size());
+    QVector<bool> read(files.size());
+    runParallel(sizes, jobs, [&](int i){
+        QFile f(files.at(i));
+        Source source;
+        read[i] = f.open(QIODevice::ReadOnly) && source.open(f);
+        if (read[i]) takeCensus(source, files.at(i), censuses[i]);
+    });
+
+    int rc = 0;
+    Census total;
+    for (int i = 0; i < files.size(); ++i) {
+        if (! read[i]) {
+            err << "Cannot read input file " << files.at(i) << endl;
+            rc = 3;
+        }
+        total.add(censuses.at(i));
+    }
+    QTextStream out(stdout);
+    out << total.toText() << flush;
+    return rc;
+}
+
+/// Writes a report to a file; "-" writes to standard output
+bool writeReport(const QString & path, const QByteArray & data)
+{
+    QFile f(path);
+    bool const opened = path == "-" ? f.open(stdout, QIODevice::WriteOnly)
+                                    : f.open(QIODevice::WriteOnly | QIODevice::Text);
+    return opened && f.write(data) == data.size();
+}
+
+/// Converts the inputs given on the command line into the outputs given
+/// with --emit, if any
+int run(const QCommandLineParser & args, const QCommandLineOption & jobsOption,
+        const QCommandLineOption & listOption, const ConvertOptions & options,
+        const QVector<OutFile> & emits, const QString & depfile)
+{
+    QStringList files = args.positionalArguments();
+    bool named = false;
+    for (auto const & o : emits)
+        if (! o.path.isEmpty()) named = true;
+    if (args.isSet(jobsOption) || args.isSet(listOption)) {
+        bool ok;
+        int const jobs = args.value(jobsOption).toInt(&ok);
+        if (! ok || jobs < 1) {
+            err << "Invalid number of jobs " << args.value(jobsOption) << endl;
+            return 1;
+        }
+        if (args.isSet(listOption) && ! readList(args.value(listOption), files)) {
+            err << "Cannot read input list " << args.value(listOption) << endl;
+            return 1;
+        }
+        if (named && files.size() > 1) {
+            err << "Several inputs can't be written to the same --emit file" << endl;
+            return 1;
+        }
+        return convertBatch(files, jobs, options, emits, depfile);
+    }
+
+    if (files.isEmpty()) {
+        if (! depfile.isEmpty()) {
+            err << "A depfile needs an input file" << endl;
+            return 1;
+        }
+        Source source;
+        QFile in;
+        QElapsedTimer timer;
+        timer.start();
+        if (! in.open(stdin, QIODevice::ReadOnly) || ! source.read(in)) {
+            err << "Error reading the input" << endl;
+            return 3;
+        }
+        if (options.stats) options.stats->nsecs[Stats::Read] += timer.nsecsElapsed();
+        if (! emits.isEmpty()) {
+            for (auto const & o : emits)
+                if (o.path.isEmpty()) {
+                    err << "Each output of the standard input needs a file, as in --emit ui=<file>" << endl;
+                    return 1;
+                }
+            return convertTo(source, emits, err, options);
+        }
+        QFile out;
+        if (! out.open(stdout, QIODevice::WriteOnly)) {
+            err << "Cannot open the standard output" << endl;
+            return 2;
+        }
+        QString diagnostics;
+        int rc = convert(source, out, diagnostics, options);
+        err << diagnostics;
+        return rc;
+    }
+    if (files.size() > 2) {
+        err << "Too many arguments; use -j or --from-list to convert several files" << endl;
+        return 1;
+    }
+    if (files.size() > 1 && ! emits.isEmpty()) {
+        err << "Name the output either with --emit or as an argument" << endl;
+        return 1;
+    }
+    FileResult r;
+    r.inPath = files.at(0);
+    r.outputs = files.size() > 1 ? QVector<OutFile>{{ options.format, files.at(1) }}
+                                 : outFiles(r.inPath, emits, options.format);
+    convertFile(r, options);
+    err << r.log;
+    if (options.stats) options.stats->add(r.stats);
+    if (! depfile.isEmpty() && ! writeDepfile(depfile, QVector<FileResult>() << r)) {
+        err << "Cannot write the depfile " << depfile << endl;
+        if (! r.rc) r.rc = 2;
+    }
+    return r.rc;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    a.setApplicationVersion(FL2UI_VERSION);
+    QCommandLineParser args;
+    args.setApplicationDescription("Converts FLUID .fl files to Qt .ui files.");
+    args.addHelpOption();
+    args.addVersionOption();
+    args.addPositionalArgument("input", "The .fl file to convert; standard input if omitted.", "[input]");
+    args.addPositionalArgument("output", "The .ui file to write; next to the input if omitted.", "[output]");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                  "Converts all inputs using <n> threads; each output is written next to its input."
+                                  " Fewer inputs than threads have their classes converted in parallel.",
+                                  "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption listOption("from-list",
+                                  "Converts the files listed in <file>, one per line; - reads the list from standard input.",
+                                  "file");
+    QCommandLineOption recoverOption("recover",
+                                     "Skips malformed widgets and converts the rest of the document.");
+    QCommandLineOption headerOption("header",
+                                    "Writes a C++ header with the setupUi() and retranslateUi() code that uic"
+                                    " would generate, instead of a .ui file; it goes to ui_<input>.h by default.");
+    QCommandLineOption emitOption("emit",
+                                  "Writes the output of <kind>: ui, header, inventory (a JSON list of the widgets)"
+                                  " or warnings. It goes to <file>, or next to the input when no file is named."
+                                  " Repeat it to write several outputs from a single parse.",
+                                  "kind[=file]");
+    QCommandLineOption maxDepthOption("max-depth",
+                                      "Fails on groups, tabs and choices nested more than <n> deep.",
+                                      "n", QString::number(ConvertOptions().maxDepth));
+    QCommandLineOption maxElementsOption("max-elements",
+                                         "Fails on documents with more than <n> elements.",
+                                         "n", QString::number(ConvertOptions().maxElements));
+    QCommandLineOption ifChangedOption("if-changed",
+                                       "Leaves output files untouched when their contents wouldn't change.");
+    QCommandLineOption depfileOption("depfile",
+                                     "Writes the input and the converter as the dependencies of each output"
+                                     " to <file>, as Makefile rules.",
+                                     "file");
+    QCommandLineOption statsOption("stats",
+                                   "Reports the time spent in each phase, counts of tokens, widgets and warnings,"
+                                   " and the bytes decoded and skipped.");
+    QCommandLineOption statsJsonOption("stats-json",
+                                       "Writes the stats as JSON to <file>; - writes to standard output.",
+                                       "file");
+    QCommandLineOption traceOption("trace",
+                                   "Writes a timeline of each file, class and widget handler to <file>"
+                                   " in the Chrome trace event format.",
+                                   "file");
+    QCommandLineOption serveOption("serve",
+                                   "Serves conversion requests over standard input and output, or over a local socket"
+                                   " with --socket, until idle for --idle-timeout seconds.");
+    QCommandLineOption socketOption("socket", "Serves requests on the local socket <name>.", "name");
+    QCommandLineOption idleOption("idle-timeout",
+                                  "Stops serving after <seconds> without requests; 0 serves forever.",
+                                  "seconds", "600");
+    QCommandLineOption scanOption("scan",
+                                  "Counts the element classes, types, label alignments and attributes of every"
+                                  " .fl file under <dir> using -j threads, and lists the constructs that aren't"
+                                  " supported, without converting anything.",
+                                  "dir");
+    QCommandLineOption cacheOption("cache",
+                                   "Reuses the output of earlier conversions of identical inputs, kept in "
+                                   + Cache::defaultDir() + ".");
+    QCommandLineOption cacheDirOption("cache-dir", "Keeps the conversion cache in <dir>.", "dir");
+    QCommandLineOption cacheSizeOption("cache-size",
+                                       "Removes the least recently used outputs when the cache exceeds <MiB>.",
+                                       "MiB", QString::number(Cache::DefaultMegabytes));
+    args.addOption(jobsOption);
+    args.addOption(listOption);
+    args.addOption(recoverOption);
+    args.addOption(headerOption);
+    args.addOption(emitOption);
+    args.addOption(maxDepthOption);
+    args.addOption(maxElementsOption);
+    args.addOption(ifChangedOption);
+    args.addOption(depfileOption);
+    args.addOption(statsOption);
+    args.addOption(statsJsonOption);
+    args.addOption(traceOption);
+    args.addOption(serveOption);
+    args.addOption(socketOption);
+    args.addOption(idleOption);
+    args.addOption(scanOption);
+    args.addOption(cacheOption);
+    args.addOption(cacheDirOption);
+    args.addOption(cacheSizeOption);
+    args.process(a);
+
+    if (args.isSet(scanOption)) {
+        bool ok;
+        int const jobs = args.value(jobsOption).toInt(&ok);
+        if (! ok || jobs < 1) {
+            err << "Invalid number of jobs " << args.value(jobsOption) << endl;
+            return 1;
+        }
+        return scanTree(args.value(scanOption), jobs);
+    }
+
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+    Stats stats;
+    Trace trace;
+    ConvertOptions options;
+    options.recover = args.isSet(recoverOption);
+    options.onlyIfChanged = args.isSet(ifChangedOption);
+    for (auto limit : { qMakePair(&maxDepthOption, &options.maxDepth),
+                        qMakePair(&maxElementsOption, &options.maxElements) }) {
+        bool ok;
+        *limit.second = args.value(*limit.first).toInt(&ok);
+        if (! ok || *limit.second < 1) {
+            err << "Invalid limit " << args.value(*limit.first) << endl;
+            return 1;
+        }
+    }
+    if (args.isSet(headerOption)) options.format = ConvertOptions::Header;
+    if (args.isSet(statsOption) || args.isSet(statsJsonOption)) options.stats = &stats;
+    if (args.isSet(traceOption)) options.trace = &trace;
+    QScopedPointer<Cache> cache;
+    if (args.isSet(cacheOption) || args.isSet(cacheDirOption)) {
+        bool ok;
+        qint64 const megabytes = args.value(cacheSizeOption).toLongLong(&ok);
+        if (! ok || megabytes < 1) {
+            err << "Invalid cache size " << args.value(cacheSizeOption) << endl;
+            return 1;
+        }
+        cache.reset(new Cache(args.isSet(cacheDirOption) ? args.value(cacheDirOption) : Cache::defaultDir(),
+                              megabytes * 1024 * 1024));
+        options.cache = cache.data();
+    }
+
+    if (args.isSet(serveOption)) {
+        ServeOptions serveOptions;
+        serveOptions.socketName = args.value(socketOption);
+        bool ok;
+        serveOptions.idleSeconds = args.value(idleOption).toInt(&ok);
+        // the timer takes milliseconds in an int
+        if (! ok || serveOptions.idleSeconds < 0 || serveOptions.idleSeconds > INT_MAX / 1000) {
+            err << "Invalid idle timeout " << args.value(idleOption) << endl;
+            return 1;
+        }
+        serveOptions.threads = args.value(jobsOption).toInt(&ok);
+        if (! ok || serveOptions.threads < 1) {
+            err << "Invalid number of jobs " << args.value(jobsOption) << endl;
+            return 1;
+        }
+        serveOptions.defaults = options;
+        serveOptions.defaults.stats = nullptr;
+        serveOptions.defaults.trace = nullptr;
+        return serve(serveOptions);
+    }
+
+    QVector<OutFile> emits;
+    if (! readEmits(args.values(emitOption), emits)) return 1;
+    int rc = run(args, jobsOption, listOption, options, emits, args.value(depfileOption));
+    qint64 const wall = wallTimer.nsecsElapsed();
+    if (args.isSet(statsOption))
+        err << "\nStats:\n" << stats.toText(wall) << flush;
+    if (args.isSet(statsJsonOption) && ! writeReport(args.value(statsJsonOption), stats.toJson(wall))) {
+        err << "Cannot write the stats to " << args.value(statsJsonOption) << endl;
+        if (! rc) rc = 2;
+    }
+    if (args.isSet(traceOption) && ! writeReport(args.value(traceOption), trace.toJson())) {
+        err << "Cannot write the trace to " << args.value(traceOption) << endl;
+        if (! rc) rc = 2;
+    }
+    return rc;
+}
@@ -0,0 +1,261 @@
+#include "serve.h"
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QPointer>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtEndian>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <fcntl.h>
+#endif
+#include "files.h"
+#include "read.h"
+
+namespace {
+
+typedef std::function<void(const QByteArray &)> Reply;
+
+/// The largest request accepted
+const quint32 maxFrame = 256 * 1024 * 1024;
+
+QByteArray frame(const QJsonObject & message)
+{
+    QByteArray const payload = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    QByteArray rv(4, 0);
+    qToBigEndian(quint32(payload.size()), reinterpret_cast<uchar *>(rv.data()));
+    return rv + payload;
+}
+
+enum FrameStatus { Incomplete, Complete, Invalid };
+
+/// Takes the first complete frame off the buffer
+FrameStatus takeFrame(QByteArray & buffer, QByteArray & payload)
+{
+    if (buffer.size() < 4) return Incomplete;
+    quint32 const size = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(buffer.constData()));
+    if (size > maxFrame) return Invalid;
+    if (quint32(buffer.size() - 4) < size) return Incomplete;
+    payload = buffer.mid(4, int(size));
+    buffer.remove(0, 4 + int(size));
+    return Complete;
+}
+
+/// Converts the document of a request
+QJsonObject handle(const QJsonObject & request, ConvertOptions options)
+{
+    QJsonObject response;
+    response["id"] = request["id"];
+    // stats and traces belong to a command-line run, not to the requests
+    options.stats = nullptr;
+    options.trace = nullptr;
+    static thread_local Scratch scratch;
+    options.scratch = &scratch;
+    QJsonObject const requested = request["options"].toObject();
+    options.recover = requested["recover"].toBool(options.recover);
+    options.onlyIfChanged = requested["ifChanged"].toBool(options.onlyIfChanged);
+
+    QString log;
+    QTextStream str(&log);
+    int rc = 0;
+    // the source maps the input file, which must stay open while it's read
+    QFile in;
+    Source source;
+    if (request.contains("content")) {
+        QBuffer content;
+        content.setData(request["content"].toString().toUtf8());
+        content.open(QIODevice::ReadOnly);
+        source.read(content);
+    }
+    else if (request.contains("input")) {
+        QString const path = request["input"].toString();
+        in.setFileName(path);
+        if (! in.open(QIODevice::ReadOnly)) {
+            str << "Cannot open input file " << path << endl;
+            rc = 1;
+        }
+        else if (! source.open(in)) {
+            str << "Error reading the input" << endl;
+            rc = 3;
+        }
+    }
+    else {
+        str << "The request has neither an input nor content" << endl;
+        rc = 1;
+    }
+
+    if (! rc && request.contains("output")) {
+        rc = convertTo(source, request["output"].toString(), str, options);
+    }
+    else if (! rc) {
+        QBuffer out;
+        out.open(QIODevice::WriteOnly);
+        QString diagnostics;
+        rc = convert(source, out, diagnostics, options);
+        str << diagnostics;
+        if (! rc || rc == 5) response["ui"] = QString::fromUtf8(out.data());
+    }
+    str.flush();
+    response["status"] = rc;
+    response["diagnostics"] = log;
+    return response;
+}
+
+class Job : public QRunnable {
+    std::function<void()> m_fn;
+public:
+    explicit Job(std::function<void()> fn) : m_fn(std::move(fn)) {}
+    void run() override { m_fn(); }
+};
+
+/// Dispatches the requests to the thread pool and tracks when to stop.
+/// Lives in the main thread.
+class Server {
+    Q_DISABLE_COPY(Server)
+public:
+    explicit Server(const ServeOptions & options) : m_options(options) {
+        m_pool.setMaxThreadCount(qMax(1, options.threads));
+        m_idle.setSingleShot(true);
+        QObject::connect(&m_idle, &QTimer::timeout, qApp, &QCoreApplication::quit);
+        idle();
+    }
+    ~Server() { m_pool.waitForDone(); }
+
+    void request(const QByteArray & payload, const Reply & reply) {
+        QJsonParseError error;
+        QJsonDocument const doc = QJsonDocument::fromJson(payload, &error);
+        if (! doc.isObject()) {
+            reply(frame({{ "status", 1 }, { "diagnostics", "Invalid request: " + error.errorString() }}));
+            return;
+        }
+        QJsonObject const request = doc.object();
+        if (request["command"].toString() == "shutdown") {
+            reply(frame({{ "id", request["id"] }, { "status", 0 }}));
+            stop();
+            return;
+        }
+        if (m_stopping) {
+            reply(frame({{ "id", request["id"] }, { "status", 1 }, { "diagnostics", "The server is shutting down" }}));
+            return;
+        }
+        ++m_active;
+        m_idle.stop();
+        ConvertOptions const defaults = m_options.defaults;
+        m_pool.start(new Job([this, request, defaults, reply]{
+            QByteArray const response = frame(handle(request, defaults));
+            QMetaObject::invokeMethod(qApp, [this, response, reply]{
+                reply(response);
+                --m_active;
+                idle();
+            }, Qt::QueuedConnection);
+        }));
+    }
+
+    /// Stops once the pending requests are answered
+    void stop() {
+        m_stopping = true;
+        idle();
+    }
+
+private:
+    void idle() {
+        if (m_active) return;
+        if (m_stopping) QTimer::singleShot(0, qApp, &QCoreApplication::quit);
+        else if (m_options.idleSeconds > 0) m_idle.start(m_options.idleSeconds * 1000);
+    }
+
+    const ServeOptions & m_options;
+    QThreadPool m_pool;
+    QTimer m_idle;
+    int m_active = 0;
+    bool m_stopping = false;
+};
+
+/// Whether the main thread still takes requests from the standard input
+/// reader. Never deleted, as the reader may outlive the server.
+struct Gate {
+    QMutex mutex;
+    bool open = true;
+};
+
+/// Reads frames from the standard input on a thread of its own, since the
+/// reads block, and passes them to the server
+void readStdin(Server & server, Gate * gate)
+{
+    auto post = [gate](std::function<void()> fn) {
+        QMutexLocker lock(&gate->mutex);
+        if (gate->open) QMetaObject::invokeMethod(qApp, fn, Qt::QueuedConnection);
+    };
+    auto reply = [](const QByteArray & response) {
+        fwrite(response.constData(), 1, size_t(response.size()), stdout);
+        fflush(stdout);
+    };
+    forever {
+        uchar header[4];
+        if (fread(header, 1, 4, stdin) != 4) break;
+        quint32 const size = qFromBigEndian<quint32>(header);
+        if (size > maxFrame) break;
+        QByteArray payload(int(size), Qt::Uninitialized);
+        if (fread(payload.data(), 1, size_t(payload.size()), stdin) != size_t(payload.size())) break;
+        post([&server, payload, reply]{ server.request(payload, reply); });
+    }
+    post([&server]{ server.stop(); });
+}
+
+}
+
+int serve(const ServeOptions & options)
+{
+    Server server(options);
+
+    if (options.socketName.isEmpty()) {
+#ifdef Q_OS_WIN
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        auto gate = new Gate;
+        std::thread(readStdin, std::ref(server), gate).detach();
+        int const rc = qApp->exec();
+        QMutexLocker lock(&gate->mutex);
+        gate->open = false;
+        return rc;
+    }
+
+    QLocalServer listener;
+    QLocalServer::removeServer(options.socketName);
+    if (! listener.listen(options.socketName)) {
+        QTextStream(stderr) << "Cannot listen on " << options.socketName << ": "
+                            << listener.errorString() << endl;
+        return 1;
+    }
+    QObject::connect(&listener, &QLocalServer::newConnection, [&]{
+        while (QLocalSocket * socket = listener.nextPendingConnection()) {
+            auto buffer = std::make_shared<QByteArray>();
+            QPointer<QLocalSocket> target(socket);
+            Reply const reply = [target](const QByteArray & response) {
+                if (target) target->write(response);
+            };
+            QObject::connect(socket, &QLocalSocket::readyRead, socket, [&server, socket, buffer, reply]{
+                *buffer += socket->readAll();
+                QByteArray payload;
+                FrameStatus status;
+                while ((status = takeFrame(*buffer, payload)) == Complete) server.request(payload, reply);
+                if (status == Invalid) socket->abort();
+            });
+            QObject::connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+    return qApp->exec();
+}
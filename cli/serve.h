@@ -0,0 +1,34 @@
+#ifndef FL2UI_SERVE_H
+#define FL2UI_SERVE_H
+
+#include <QString>
+#include "convert.h"
+
+struct ServeOptions {
+    /// Listens on this local socket; standard input and output are used
+    /// when it's empty
+    QString socketName;
+    /// Exits after this many seconds without requests; zero waits forever
+    int idleSeconds = 600;
+    /// Requests converted at the same time
+    int threads = 1;
+    /// Applies to requests that don't give their own options
+    ConvertOptions defaults;
+};
+
+/// Serves conversion requests until the input ends, a shutdown request
+/// arrives, or the server has been idle for the timeout. Each request and
+/// response is a JSON object preceded by its length as a 32-bit big-endian
+/// integer.
+///
+/// A request has an "id", which is echoed, and either an "input" path or
+/// the "content" of the document. The .ui document is written to the
+/// "output" path if one is given, and returned as "ui" otherwise. The
+/// "options" object may set "recover" and "ifChanged". A response has the "status" of
+/// the conversion and its "diagnostics". The request {"command": "shutdown"}
+/// stops the server once the pending requests are answered.
+///
+/// Returns the exit status of the server.
+int serve(const ServeOptions & options);
+
+#endif // FL2UI_SERVE_H
@@ -1,16 +1,13 @@
-QT       += core
-QT       -= gui
+TEMPLATE = subdirs
 
-TARGET = fl2ui
-CONFIG   += console c++11
-CONFIG   -= app_bundle
+# libfl2ui converts documents in memory; cli is the fl2ui command line tool
+SUBDIRS += \
+    libfl2ui \
+    cli
 
-TEMPLATE = app
+cli.depends = libfl2ui
 
-SOURCES += main.cpp \
-    read.cpp
+# the benchmarks and checks in bench, when configured with CONFIG+=fl2ui_bench
+fl2ui_bench: SUBDIRS += bench
 
 OTHER_FILES += LICENSE COPYING README.md
-
-HEADERS += \
-    read.h
@@ -0,0 +1,52 @@
+#include "arena.h"
+#include <cstdlib>
+#include <new>
+
+/// The alignment of every allocation
+static const size_t alignment = alignof(std::max_align_t);
+
+Arena::~Arena()
+{
+    reset();
+    free(m_blocks);
+}
+
+void * Arena::allocate(size_t size)
+{
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if (size_t(m_end - m_next) < size) {
+        // an allocation larger than a block gets a block of its own size
+        size_t const blockSize = qMax(size, size_t(BlockSize));
+        auto block = static_cast<Block *>(malloc(sizeof(Block) + blockSize));
+        if (! block) throw std::bad_alloc();
+        block->next = m_blocks;
+        block->size = blockSize;
+        m_blocks = block;
+        m_next = block->data();
+        m_end = m_next + blockSize;
+    }
+    void * rv = m_next;
+    m_next += size;
+    return rv;
+}
+
+const char * Arena::copy(const char * data, int size)
+{
+    if (size <= 0) return "";
+    auto rv = static_cast<char *>(allocate(size_t(size)));
+    memcpy(rv, data, size_t(size));
+    return rv;
+}
+
+void Arena::reset()
+{
+    if (! m_blocks) return;
+    // the oldest block is kept
+    while (m_blocks->next) {
+        Block * const next = m_blocks->next;
+        free(m_blocks);
+        m_blocks = next;
+    }
+    m_next = m_blocks->data();
+    m_end = m_next + m_blocks->size;
+}
@@ -0,0 +1,48 @@
+#ifndef FL2UI_ARENA_H
+#define FL2UI_ARENA_H
+
+#include <QString>
+#include <cstddef>
+#include <cstring>
+
+/// Hands out memory from large blocks, all of which is freed at once
+class Arena {
+    Q_DISABLE_COPY(Arena)
+public:
+    enum { BlockSize = 16 * 1024 };
+    Arena() = default;
+    ~Arena();
+    /// Uninitialized memory, aligned for any type, that lasts until the reset
+    void * allocate(size_t size);
+    /// Copies the bytes into the arena
+    const char * copy(const char * data, int size);
+    /// Frees everything allocated, keeping the first block for reuse
+    void reset();
+private:
+    struct alignas(std::max_align_t) Block {
+        Block * next;
+        size_t size;    ///< of the memory that follows the header
+        char * data() { return reinterpret_cast<char *>(this + 1); }
+    };
+    Block * m_blocks = nullptr;
+    char * m_next = nullptr;
+    char * m_end = nullptr;
+};
+
+/// A view of UTF-8 text in the source, an arena, or a string literal
+struct Text {
+    const char * data = nullptr;
+    int size = 0;
+    Text() = default;
+    Text(const char * data, int size) : data(data), size(size) {}
+    /// A view of a string that outlives it, usually a literal
+    Text(const char * str) : data(str), size(int(strlen(str))) {}
+    bool isEmpty() const { return size == 0; }
+    QString toString() const { return QString::fromUtf8(data, size); }
+    bool operator==(const char * str) const {
+        return int(strlen(str)) == size && ! memcmp(data, str, size_t(size));
+    }
+    bool operator!=(const char * str) const { return ! (*this == str); }
+};
+
+#endif // FL2UI_ARENA_H
@@ -0,0 +1,58 @@
+#include "attributes.h"
+
+static const char * const keyNames[Attributes::KeyCount] = {
+    nullptr, nullptr,
+    "label", "type", "align", "value", "minimum", "maximum", "step", "box", "labelsize", "xywh"
+};
+
+Attributes::Key Attributes::key(const Lexer & in, const Token & name)
+{
+    for (int k = Label; k < KeyCount; ++k)
+        if (in.is(name, keyNames[k])) return Key(k);
+    return KeyCount;
+}
+
+void Attributes::set(Key key, const Text & text)
+{
+    m_present |= 1u << key;
+    m_text[key] = text;
+    switch (key) {
+    case Align:
+    case LabelSize:
+        m_number[key] = QByteArray::fromRawData(text.data, text.size).toInt();
+        break;
+    case Value:
+    case Minimum:
+    case Maximum:
+    case Step:
+        m_number[key] = QByteArray::fromRawData(text.data, text.size).toDouble();
+        break;
+    default:
+        break;
+    }
+}
+
+void Attributes::remove(Key key)
+{
+    m_present &= ~(1u << key);
+    m_text[key] = Text();
+    m_number[key] = 0;
+    if (key == Xywh) m_xywh = m_sourceXywh = QRect();
+}
+
+void Attributes::setXywh(const QRect & source, const QPoint & parentTopLeft)
+{
+    m_present |= 1u << Xywh;
+    m_sourceXywh = source;
+    m_xywh = source.translated(-parentTopLeft);
+}
+
+void Attributes::rebase(const char * from, int size, const char * to, int pos, int delta)
+{
+    for (auto & text : m_text) {
+        // texts in the arena or in literals stay
+        quintptr const offset = quintptr(text.data) - quintptr(from);
+        if (! text.data || offset >= quintptr(size)) continue;
+        text.data = to + (int(offset) >= pos ? int(offset) + delta : int(offset));
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef FL2UI_ATTRIBUTES_H
+#define FL2UI_ATTRIBUTES_H
+
+#include <QRect>
+#include <QString>
+#include "arena.h"
+#include "read.h"
+
+/// The attributes of an item. The known attributes have fixed slots, with
+/// numeric values parsed up front; the others are skipped, as nothing reads
+/// them. The texts are views of the source or of the arena the item was
+/// read into, so that attributes are cheap to copy.
+class Attributes {
+public:
+    enum Key : quint8 {
+        // Set by the parser
+        Name, Title,
+        // Read from the source
+        Label, Type, Align, Value, Minimum, Maximum, Step, Box, LabelSize, Xywh,
+        KeyCount
+    };
+    /// The key of the given attribute name, or KeyCount if it's not known
+    static Key key(const Lexer & in, const Token & name);
+
+    bool has(Key key) const { return m_present & (1u << key); }
+    /// The text of the attribute, empty if it's not present
+    QString text(Key key) const { return m_text[key].toString(); }
+    const Text & view(Key key) const { return m_text[key]; }
+    /// The value of a numeric attribute, zero if it's not present
+    double number(Key key) const { return m_number[key]; }
+    int toInt(Key key) const { return int(m_number[key]); }
+    void set(Key key, const Text & text);
+    void remove(Key key);
+
+    /// The geometry relative to the parent widget, null if it's not present
+    const QRect & xywh() const { return m_xywh; }
+    /// The geometry as given in the source
+    const QRect & sourceXywh() const { return m_sourceXywh; }
+    void setXywh(const QRect & source, const QPoint & parentTopLeft);
+    /// Moves the views of the source from one copy of it to another, in
+    /// which the bytes from pos on moved by delta
+    void rebase(const char * from, int size, const char * to, int pos, int delta);
+
+private:
+    Text m_text[KeyCount];
+    double m_number[KeyCount] = {};
+    QRect m_xywh;
+    QRect m_sourceXywh;
+    quint16 m_present = 0;
+};
+
+#endif // FL2UI_ATTRIBUTES_H
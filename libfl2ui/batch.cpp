@@ -0,0 +1,93 @@
+#include "batch.h"
+#include <QThread>
+#include <QMutex>
+#include <algorithm>
+
+namespace {
+
+/// The tasks dealt to one thread, heaviest first. The owner takes from the
+/// front, thieves from the back.
+class TaskQueue {
+    QMutex m_mutex;
+    QVector<int> m_tasks;
+    int m_head = 0;
+public:
+    void append(int task) { m_tasks.append(task); }
+    int size() {
+        QMutexLocker lock(&m_mutex);
+        return m_tasks.size() - m_head;
+    }
+    bool take(int & task) {
+        QMutexLocker lock(&m_mutex);
+        if (m_head == m_tasks.size()) return false;
+        task = m_tasks.at(m_head++);
+        return true;
+    }
+    bool steal(int & task) {
+        QMutexLocker lock(&m_mutex);
+        if (m_head == m_tasks.size()) return false;
+        task = m_tasks.takeLast();
+        return true;
+    }
+};
+
+class Worker : public QThread {
+    QVector<TaskQueue *> & m_queues;
+    int const m_index;
+    const std::function<void(int)> & m_task;
+public:
+    Worker(QVector<TaskQueue *> & queues, int index, const std::function<void(int)> & task) :
+        m_queues(queues), m_index(index), m_task(task) {}
+    void run() override {
+        int task;
+        for (;;) {
+            if (m_queues[m_index]->take(task) || stealFromBusiest(task)) m_task(task);
+            else return;
+        }
+    }
+private:
+    bool stealFromBusiest(int & task) {
+        for (;;) {
+            TaskQueue * victim = nullptr;
+            int most = 0;
+            for (auto q : m_queues) {
+                int const n = q->size();
+                if (n > most) { most = n; victim = q; }
+            }
+            if (! victim) return false;
+            // another thief may have emptied the victim meanwhile
+            if (victim->steal(task)) return true;
+        }
+    }
+};
+
+}
+
+void runParallel(const QVector<qint64> & weights, int threads,
+                 const std::function<void(int)> & task)
+{
+    QVector<int> order(weights.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+        return weights.at(a) > weights.at(b);
+    });
+    threads = qBound(1, threads, qMax(1, order.size()));
+    if (threads == 1) {
+        for (int i : order) task(i);
+        return;
+    }
+
+    QVector<TaskQueue *> queues;
+    for (int t = 0; t < threads; ++t) queues.append(new TaskQueue);
+    for (int i = 0; i < order.size(); ++i)
+        queues[i % threads]->append(order.at(i));
+
+    QVector<Worker *> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.append(new Worker(queues, t, task));
+        workers.last()->start();
+    }
+    for (auto w : workers) w->wait();
+    qDeleteAll(workers);
+    qDeleteAll(queues);
+}
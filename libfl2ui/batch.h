@@ -0,0 +1,14 @@
+#ifndef FL2UI_BATCH_H
+#define FL2UI_BATCH_H
+
+#include <QVector>
+#include <functional>
+#include "fl2ui.h"
+
+/// Runs task(i) for every index of weights on up to the given number of
+/// threads. The heaviest tasks start first; a thread that runs out of work
+/// steals from the thread with the most work left.
+FL2UI_EXPORT void runParallel(const QVector<qint64> & weights, int threads,
+                              const std::function<void(int)> & task);
+
+#endif // FL2UI_BATCH_H
@@ -0,0 +1,122 @@
+#include "cache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+#include <algorithm>
+#include "convert.h"
+#include "read.h"
+
+/// Identifies the layout of an entry
+static const quint32 entryMagic = 0xF12C0002;
+
+Cache::Cache(const QString & dir, qint64 maxBytes) :
+    m_dir(dir), m_maxBytes(maxBytes)
+{}
+
+Cache::~Cache()
+{
+    if (m_stored) trim();
+}
+
+QString Cache::defaultDir()
+{
+    QString const base = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    return (base.isEmpty() ? QDir::tempPath() : base) + "/fl2ui";
+}
+
+QByteArray Cache::key(const Source & source, const ConvertOptions & options)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(FL2UI_VERSION);
+    hash.addData(options.recover ? "\1" : "\0", 1);
+    static const char formats[] = "uhiw";
+    hash.addData(&formats[options.format], 1);
+    // recovering from the depth limit skips elements, which changes the output
+    hash.addData(reinterpret_cast<const char *>(&options.maxDepth), sizeof(options.maxDepth));
+    hash.addData(reinterpret_cast<const char *>(&options.maxElements), sizeof(options.maxElements));
+    hash.addData(source.data(), source.size());
+    return hash.result().toHex();
+}
+
+QString Cache::path(const QByteArray & key) const
+{
+    // a level of subdirectories keeps the directories small
+    return m_dir + "/" + QString::fromLatin1(key.left(2)) + "/" + QString::fromLatin1(key.mid(2)) + ".entry";
+}
+
+bool Cache::lookup(const QByteArray & key, CacheEntry & entry) const
+{
+    QString const name = path(key);
+    QFile f(name);
+    if (! f.open(QIODevice::ReadOnly)) return false;
+    QDataStream str(&f);
+    str.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    qint32 rc = 0;
+    str >> magic >> rc >> entry.messages >> entry.ui;
+    if (str.status() != QDataStream::Ok || magic != entryMagic) return false;
+    entry.rc = rc;
+    f.close();
+
+    // the modification time records the last use
+    QFile touch(name);
+    if (touch.open(QIODevice::Append))
+        touch.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return true;
+}
+
+void Cache::store(const QByteArray & key, const CacheEntry & entry)
+{
+    QString const name = path(key);
+    QDir().mkpath(QFileInfo(name).path());
+    QSaveFile f(name);
+    if (! f.open(QIODevice::WriteOnly)) return;
+    QDataStream str(&f);
+    str.setVersion(QDataStream::Qt_5_0);
+    str << entryMagic << qint32(entry.rc) << entry.messages << entry.ui;
+    if (str.status() != QDataStream::Ok || ! f.commit()) return;
+
+    QMutexLocker lock(&m_mutex);
+    m_stored += entry.ui.size();
+    for (auto const & message : entry.messages) m_stored += message.size() * 2;
+    // a long-running process trims as it goes, rather than only at the end
+    bool const due = m_stored > m_maxBytes / 8;
+    lock.unlock();
+    if (due) trim();
+}
+
+void Cache::trim()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stored = 0;
+
+    struct Item {
+        QDateTime used;
+        qint64 size;
+        QString path;
+    };
+    QVector<Item> items;
+    qint64 total = 0;
+    QDirIterator it(m_dir, QStringList() << "*.entry", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo const fi = it.fileInfo();
+        items.append({ fi.lastModified(), fi.size(), fi.filePath() });
+        total += fi.size();
+    }
+    if (total <= m_maxBytes) return;
+
+    std::sort(items.begin(), items.end(), [](const Item & a, const Item & b){ return a.used < b.used; });
+    for (auto const & item : items) {
+        if (total <= m_maxBytes) break;
+        // another process may have removed it already, or may be reading it
+        if (QFile::remove(item.path)) total -= item.size;
+    }
+}
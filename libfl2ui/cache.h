@@ -0,0 +1,49 @@
+#ifndef FL2UI_CACHE_H
+#define FL2UI_CACHE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include "fl2ui.h"
+
+class Source;
+
+/// A converted document as kept in the cache
+struct CacheEntry {
+    int rc = 0;
+    QStringList messages;   ///< the diagnostics, one message each
+    QByteArray ui;
+};
+
+/// An on-disk cache of converted documents, keyed by a hash of the input,
+/// the converter version and the options that change the output. Entries
+/// are written to a temporary file and renamed into place, so concurrent
+/// threads and processes can share a directory. Each hit touches the entry;
+/// the least recently used entries are removed when the cache grows past
+/// its size.
+class FL2UI_EXPORT Cache {
+    Q_DISABLE_COPY(Cache)
+public:
+    enum { DefaultMegabytes = 256 };
+    Cache(const QString & dir, qint64 maxBytes);
+    /// Trims the cache if anything was stored
+    ~Cache();
+    /// The per-user cache directory
+    static QString defaultDir();
+    static QByteArray key(const Source & source, const ConvertOptions & options);
+    /// Reads the entry; false if there is none or it's unreadable
+    bool lookup(const QByteArray & key, CacheEntry & entry) const;
+    /// Stores the entry; failures only cost a later miss
+    void store(const QByteArray & key, const CacheEntry & entry);
+    /// Removes the least recently used entries until the cache fits
+    void trim();
+private:
+    QString path(const QByteArray & key) const;
+    QString m_dir;
+    qint64 m_maxBytes;
+    QMutex m_mutex;
+    qint64 m_stored = 0;    ///< bytes stored since the last trim
+};
+
+#endif // FL2UI_CACHE_H
@@ -0,0 +1,177 @@
+#include "census.h"
+#include <QTextStream>
+#include <QVector>
+#include <QPair>
+#include <algorithm>
+#include <cstring>
+#include "parser.h"
+#include "read.h"
+
+namespace {
+
+/// The FLTK label alignment flags
+const struct { int bit; const char * name; } alignFlags[] = {
+    { 1, "FL_ALIGN_TOP" },
+    { 2, "FL_ALIGN_BOTTOM" },
+    { 4, "FL_ALIGN_LEFT" },
+    { 8, "FL_ALIGN_RIGHT" },
+    { 16, "FL_ALIGN_INSIDE" },
+    { 32, "FL_ALIGN_TEXT_OVER_IMAGE" },
+    { 64, "FL_ALIGN_CLIP" },
+    { 128, "FL_ALIGN_WRAP" },
+    { 256, "FL_ALIGN_IMAGE_NEXT_TO_TEXT" },
+    { 512, "FL_ALIGN_IMAGE_BACKDROP" },
+};
+
+/// The alignment flags that genLabel converts
+const int supportedAligns = 0x1F;
+
+/// Attributes that stand alone, without a value
+const char * const flags[] = {
+    "open", "hide", "deactivate", "resizable", "hotspot", "divider", "visible", "selected",
+    "modal", "non_modal", "noborder", "local", "global", "private", "public", "protected",
+    "in_source", "in_header", "C"
+};
+
+/// The line numbers of increasing offsets, counted from the previous one
+class Lines {
+public:
+    explicit Lines(const char * data) : m_data(data) {}
+    int at(int offset) {
+        for (const char * p = m_data + m_pos, * end = m_data + offset;
+             (p = static_cast<const char *>(memchr(p, '\n', size_t(end - p)))); ++p)
+            ++m_line;
+        m_pos = offset;
+        return m_line;
+    }
+private:
+    const char * m_data;
+    int m_pos = 0;
+    int m_line = 1;
+};
+
+/// The UTF-8 text of the token; a view of the source unless it has escapes
+QByteArray bytes(const Lexer & in, const Token & t)
+{
+    if (t.escaped) return in.text(t).toUtf8();
+    return QByteArray::fromRawData(in.data() + t.offset, t.length);
+}
+
+/// Counts the key once more, copying it only when it's new
+void tally(QMap<QByteArray, qint64> & counts, const QByteArray & key)
+{
+    auto i = counts.find(key);
+    if (i == counts.end()) i = counts.insert(QByteArray(key.constData(), key.size()), 0);
+    ++i.value();
+}
+
+bool isFlag(const Lexer & in, const Token & t)
+{
+    for (auto flag : flags)
+        if (in.is(t, flag)) return true;
+    return false;
+}
+
+/// Whether the token opens a brace read on its own
+bool isOpening(const Lexer & in, const Token & t)
+{
+    return t.kind == Token::Brace && in.data()[t.offset] == '{';
+}
+
+/// Whether the converter handles elements of the class
+bool isSupported(const Lexer & in, const Token & t)
+{
+    return findVisual(in, t) || in.is(t, "class") || in.is(t, "Function") || in.is(t, "Fl_Window");
+}
+
+}
+
+void takeCensus(const Source & source, const QString & path, Census & census)
+{
+    Lexer in(source);
+    Lines lines(source.data());
+    census.files += 1;
+    census.bytes += source.size();
+    forever {
+        // an element is its class and name, then its attributes and its
+        // children in braces; the closing braces of the children are passed
+        Token const t = in.next();
+        if (t.isNull()) break;
+        if (t.kind != Token::Word) continue;
+        Token const name = in.next();
+        if (name.kind == Token::Brace) continue;
+        int const afterName = in.pos();
+        if (! isOpening(in, in.next(true))) {
+            // a document option and its value
+            in.seek(afterName);
+            continue;
+        }
+        QByteArray const class_ = bytes(in, t);
+        tally(census.classes, class_);
+        if (! isSupported(in, t))
+            census.unsupported << QString("%1:%2: %3").arg(path).arg(lines.at(t.offset)).arg(QString::fromUtf8(class_));
+
+        forever {
+            Token const attr = in.next();
+            if (attr.isNull() || attr.kind == Token::Brace) break;
+            if (attr.kind != Token::Word) continue;
+            tally(census.attributes, bytes(in, attr));
+            if (isFlag(in, attr)) continue;
+            Token const value = in.next();
+            if (value.isNull() || value.kind == Token::Brace) break;
+            if (in.is(attr, "type")) {
+                tally(census.types, class_ + ' ' + bytes(in, value));
+            }
+            else if (in.is(attr, "align")) {
+                int const align = bytes(in, value).toInt();
+                if (! align) tally(census.aligns, "FL_ALIGN_CENTER");
+                for (auto const & flag : alignFlags)
+                    if (align & flag.bit) tally(census.aligns, flag.name);
+                if (align & ~supportedAligns)
+                    census.unsupported << QString("%1:%2: %3 label alignment %4")
+                                          .arg(path).arg(lines.at(value.offset))
+                                          .arg(QString::fromUtf8(class_)).arg(align);
+            }
+        }
+
+        int const afterAttributes = in.pos();
+        if (! isOpening(in, in.next(true))) in.seek(afterAttributes);
+    }
+}
+
+void Census::add(const Census & other)
+{
+    files += other.files;
+    bytes += other.bytes;
+    for (auto i = other.classes.begin(); i != other.classes.end(); ++i) classes[i.key()] += i.value();
+    for (auto i = other.types.begin(); i != other.types.end(); ++i) types[i.key()] += i.value();
+    for (auto i = other.aligns.begin(); i != other.aligns.end(); ++i) aligns[i.key()] += i.value();
+    for (auto i = other.attributes.begin(); i != other.attributes.end(); ++i) attributes[i.key()] += i.value();
+    unsupported += other.unsupported;
+}
+
+/// Writes the counts, the most frequent first
+static void writeHistogram(QTextStream & str, const char * title, const QMap<QByteArray, qint64> & counts)
+{
+    QVector<QPair<qint64, QByteArray>> sorted;
+    for (auto i = counts.begin(); i != counts.end(); ++i) sorted.append(qMakePair(-i.value(), i.key()));
+    std::sort(sorted.begin(), sorted.end());
+    str << title << ":\n";
+    for (auto const & entry : sorted)
+        str << "  " << QString::fromUtf8(entry.second).leftJustified(29) << -entry.first << "\n";
+}
+
+QString Census::toText() const
+{
+    QString rv;
+    QTextStream str(&rv);
+    str << "Files: " << files << ", " << bytes << " bytes\n";
+    writeHistogram(str, "Classes", classes);
+    writeHistogram(str, "Types", types);
+    writeHistogram(str, "Label alignments", aligns);
+    writeHistogram(str, "Attributes", attributes);
+    str << "Unsupported: " << unsupported.size() << "\n";
+    for (auto const & construct : unsupported) str << "  " << construct << "\n";
+    str.flush();
+    return rv;
+}
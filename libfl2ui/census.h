@@ -0,0 +1,33 @@
+#ifndef FL2UI_CENSUS_H
+#define FL2UI_CENSUS_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QStringList>
+#include "fl2ui.h"
+
+class Source;
+
+/// How often the constructs of FLUID documents occur, for planning a
+/// migration. The counts are keyed by the UTF-8 text of the source.
+struct FL2UI_EXPORT Census {
+    qint64 files = 0;
+    qint64 bytes = 0;
+    QMap<QByteArray, qint64> classes;       ///< elements by class
+    QMap<QByteArray, qint64> types;         ///< "<class> <type>" for each type attribute
+    QMap<QByteArray, qint64> aligns;        ///< label alignment flags by name
+    QMap<QByteArray, qint64> attributes;    ///< attributes by name
+    QStringList unsupported;                ///< "<path>:<line>: <construct>", in source order
+
+    /// Accumulates the census of other documents
+    void add(const Census & other);
+    /// A human-readable report, with the most frequent constructs first
+    QString toText() const;
+};
+
+/// Counts the constructs of a document without converting it. Only the
+/// element classes and the attributes are read; names, code and callback
+/// bodies are skipped whole. The path prefixes the unsupported constructs.
+FL2UI_EXPORT void takeCensus(const Source & source, const QString & path, Census & census);
+
+#endif // FL2UI_CENSUS_H
@@ -0,0 +1,1428 @@
+#include "convert.h"
+#include <QStringList>
+#include <QRect>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <QBuffer>
+#include <QPair>
+#include <algorithm>
+#include <cstring>
+#include "attributes.h"
+#include "batch.h"
+#include "cache.h"
+#include "emitter.h"
+#include "parser.h"
+#include "perfecthash.h"
+#include "reports.h"
+#include "setupui.h"
+#include "sink.h"
+#include "stats.h"
+
+const Element noElement = { "", Kind::Production, nullptr, nullptr, nullptr };
+
+void Span::begin(const char * name)
+{
+    m_name = name;
+    m_parent = c.span;
+    m_start = c.trace->now();
+    m_pos = c.in.pos();
+    c.span = this;
+}
+
+void Span::end()
+{
+    int const bytes = c.in.pos() - m_pos;
+    if (bytes) args["bytes"] = bytes;
+    c.events.append({ m_name, m_start, c.trace->now() - m_start, args });
+    c.span = m_parent;
+}
+
+void Span::setWidget(const QString & class_, const QString & name)
+{
+    if (args.contains("q_name")) return;
+    args["q_class"] = class_;
+    args["q_name"] = name;
+}
+
+/// Find a unique name for an object of given class
+QString objectName(Context & c, QString const & class_, QString name = QString::Null())
+{
+    if (c.replayedNames >= 0) return c.names.at(c.replayedNames++).result;
+    QString const requested = name;
+    QString stem = name;
+    if (stem.isEmpty()) {
+        stem = class_.startsWith('Q') ? class_.mid(1) : class_;
+        stem[0] = stem[0].toLower();
+        name = stem;
+    }
+    while (c.objectNames.contains(name)) {
+        if (! c.objectNameCounter.contains(stem)) {
+            c.objectNameCounter[stem] = 2;
+        }
+        name = QString("%1_%2").arg(stem).arg(c.objectNameCounter[stem]++);
+    }
+    c.objectNames.insert(name);
+    if (c.recordNames) c.names.append({ class_, requested, name });
+    return name;
+}
+
+QString elide(const QString & str, int len = 30)
+{
+    return (str.length() <= len) ? str : str.left(len) + "...";
+}
+
+QString elide(const QVariant & var, int len = 30)
+{
+    return elide(var.toString(), len);
+}
+
+QString ParseError::describe() const
+{
+    QString rv;
+    QTextStream str(&rv);
+    str << line << ":" << column << ": " << message << "\n" << excerpt << "Last words read:\n";
+    for (auto const & w : lastWords) {
+        if (!w.isEmpty())
+            str << elide(w) << " ";
+        else
+            str << "\"\" ";
+    }
+    str << "\nStack:\n";
+    for (auto const & name : stack) str << name << "\n";
+    str.flush();
+    return rv;
+}
+
+/// A position in the source, counted from one
+struct Position {
+    int line = 1;
+    int column = 1;     ///< in characters
+    int lineStart = 0;  ///< byte offset of the line
+};
+
+Position position(const Lexer & in, int offset)
+{
+    Position p;
+    const char * const data = in.data();
+    for (int i = 0; i < offset; ++i) {
+        if (data[i] == '\n') {
+            ++p.line;
+            p.lineStart = i + 1;
+        }
+    }
+    for (int i = p.lineStart; i < offset; ++i)
+        if ((uchar(data[i]) & 0xC0) != 0x80) ++p.column;
+    return p;
+}
+
+/// The source line at the position, with a caret under the column
+QString excerpt(const Lexer & in, const Position & p)
+{
+    const char * const data = in.data();
+    int end = p.lineStart;
+    while (end < in.size() && data[end] != '\n' && data[end] != '\r') ++end;
+    QString const text = QString::fromUtf8(data + p.lineStart, end - p.lineStart);
+    QString const number = QString::number(p.line);
+    QString caret;
+    for (int i = 0; i < p.column - 1 && i < text.size(); ++i)
+        caret += text.at(i) == '\t' ? '\t' : ' ';
+    return QString("%1 | %2\n%3 | %4^\n").arg(number, text, QString(number.size(), ' '), caret);
+}
+
+/// The most elements of the parse stack that a ParseError lists
+enum { MaxStackShown = 32 };
+
+void perr(Context & c, const QString & msg, int rc)
+{
+    ParseError e;
+    e.message = msg;
+    e.rc = rc;
+    unsigned const count = qMin(c.recentCount, unsigned(Context::RecentTokens));
+    e.offset = count ? c.recent[(c.recentCount - 1) % Context::RecentTokens].offset : c.in.pos();
+    Position const p = position(c.in, e.offset);
+    e.line = p.line;
+    e.column = p.column;
+    e.excerpt = excerpt(c.in, p);
+    for (unsigned i = c.recentCount - count; i != c.recentCount; ++i) {
+        auto const & t = c.recent[i % Context::RecentTokens];
+        if (! t.isNull()) e.lastWords << c.in.text(t);
+    }
+    // deeply nested documents list only the innermost elements
+    int const shown = qMax(0, c.frames.size() - MaxStackShown);
+    for (int i = c.frames.size() - 1; i >= shown; --i)
+        e.stack << QString("%1 (line %2)").arg(c.frames[i].element->name).arg(position(c.in, c.frames[i].offset).line);
+    if (shown) e.stack << QString("%1 outer elements").arg(shown);
+    throw e;
+}
+
+/// Passes the diagnostics written since the last call to the callback
+void deliver(Context & c)
+{
+    if (! c.options.diagnostics) return;
+    c.err.flush();
+    QString const & text = *c.err.string();
+    if (text.size() > c.delivered) {
+        c.options.diagnostics(text.mid(c.delivered));
+        c.delivered = text.size();
+    }
+}
+
+QTextStream & warn(Context & c)
+{
+    // the previous message is complete
+    deliver(c);
+    ++c.warnings;
+    c.err << "Warning: ";
+    c.err.flush();
+    c.warningAt.append(c.err.string()->size());
+    return c.err;
+}
+
+/// Passes each warning to the emitter
+void passWarnings(Context & c)
+{
+    c.err.flush();
+    QString const & text = *c.err.string();
+    for (int const start : c.warningAt) {
+        int const end = text.indexOf('\n', start);
+        c.out.warning(text.mid(start, end < 0 ? -1 : end - start));
+    }
+}
+
+void generateTree(Context & c)
+{
+    c.out.startDocument();
+    emitNode(c, c.tree.at(Tree::Root));
+    passWarnings(c);
+    c.out.endDocument();
+}
+
+Token readWordDiag(Context & c, bool readBrace = false)
+{
+    Token rv;
+    if (auto stats = c.options.stats) {
+        QElapsedTimer timer;
+        timer.start();
+        rv = c.in.next(readBrace);
+        stats->nsecs[Stats::Tokenize] += timer.nsecsElapsed();
+        if (! rv.isNull()) ++stats->tokens;
+    }
+    else {
+        rv = c.in.next(readBrace);
+    }
+    if (rv.kind == Token::Brace) c.depth += c.in.data()[rv.offset] == '{' ? 1 : -1;
+    Token & recent = c.recent[c.recentCount++ % Context::RecentTokens];
+    recent = rv;
+    if (rv.isNull()) recent.offset = c.in.pos();
+    return rv;
+}
+
+/// Reads a word without decoding it
+Token token(Context & c, const char * expect = nullptr)
+{
+    Token rv = readWordDiag(c);
+    if (rv.isNull())
+        perr(c, "premature end of input");
+    if (expect && ! c.in.is(rv, expect))
+        perr(c, QString("expected \"%1\", got \"%2\"").arg(expect).arg(elide(c.in.text(rv))));
+    return rv;
+}
+
+QString word(Context & c, const char * expect = nullptr)
+{
+    return c.in.text(token(c, expect));
+}
+
+void brace(Context & c, char ch)
+{
+    Token rv = readWordDiag(c, true);
+    if (! c.in.is(rv, ch))
+        perr(c, QString("expected \"%1\", got \"%2\"").arg(ch).arg(elide(c.in.text(rv))));
+}
+
+void upto(Context & c, char ch)
+{
+    while (! c.in.is(token(c), ch));
+}
+
+void writeGeometry(Emitter & out, const QRect & r)
+{
+    if (r.isNull()) return;
+    out.geometry(r);
+}
+
+void writeText(Emitter & out, const QString & text)
+{
+    if (text.isEmpty()) return;
+    out.property("text", "string", text);
+}
+
+void writeAttribute(Emitter & out, const QString & name, const QString & string)
+{
+    if (string.isEmpty()) return;
+    out.attribute(name, string);
+}
+
+void writeAttrProperty(Emitter & out, const QString & name, const QString & elem, const Attributes & attrs, Attributes::Key key)
+{
+    if (!attrs.has(key)) return;
+    out.property(name, elem, attrs.text(key));
+}
+
+void writeOrientation(Emitter & out, Qt::Orientation ori)
+{
+    out.property("orientation", "enum", ori == Qt::Vertical ? "Qt::Vertical" : "Qt::Horizontal");
+}
+
+/// Starts a widget element; returns its object name
+QString writeStartWidget(Context & c, const QString & class_, const QString & name, const QRect & geometry,
+                         const QString & text, const QString & title = QString::Null())
+{
+    QString const objName = objectName(c, class_, name);
+    c.out.startWidget(class_, objName);
+    writeGeometry(c.out, geometry);
+    writeText(c.out, text);
+    writeAttribute(c.out, "title", title);
+    return objName;
+}
+
+void writeStartWidget(Context & c, const QString & class_, const Attributes & attrs)
+{
+    QString const name = writeStartWidget(c, class_, attrs.text(Attributes::Name), attrs.xywh(),
+                                          attrs.text(Attributes::Label), attrs.text(Attributes::Title));
+    if (c.span) c.span->setWidget(class_, name);
+}
+
+void writeEndWidget(Context & c)
+{
+    c.out.endWidget();
+}
+
+/// Generate a label for an item that could have an optional label
+void genLabel(Context & c, Attributes & attrs)
+{
+    enum {
+        Center = 0,
+        Top = 1,
+        Bottom = 2,
+        Left = 4,
+        Right = 8,
+        Inside = 16,
+        KnownMask = 0x1F,
+        LeftTop = 7,
+        RightTop = 0xB,
+        LeftBottom = 0xD,
+        RightBottom = 0xE
+    };
+    /* Outside alignments are as follows:
+     * Top Left,Right: Top|Left...
+     * Left Top,Bottom: LeftTop, LeftBottom
+     * Right Top,Bottom: RightTop, RightBottom
+     * Bottom Left,Right: Bottom|Left...
+    */
+    if (!attrs.has(Attributes::Label) || !attrs.has(Attributes::Xywh)) return;
+    bool hasAlign = attrs.has(Attributes::Align);
+    int align = hasAlign ? attrs.toInt(Attributes::Align) : Center|Inside;
+    if (align & ~KnownMask) {
+        warn(c) << "Ignoring an unimplemented label alignment " << elide(attrs.text(Attributes::Align))
+            << " in label for element " << elide(attrs.text(Attributes::Name)) << endl;
+    }
+    align &= KnownMask;
+    bool outside = ! (align & Inside);
+    QRect r = attrs.xywh();
+    QStringList alignList;
+    if (align == LeftTop) {
+        alignList << "Qt::AlignRight" << "Qt::AlignTop";
+        r.moveTopRight(r.topLeft());
+    }
+    else if (align == RightTop) {
+        alignList << "Qt::AlignLeft" << "Qt::AlignTop";
+        r.moveTopLeft(r.topRight());
+    }
+    else if (align == LeftBottom) {
+        alignList << "Qt::AlignRight" << "Qt::AlignBottom";
+        r.moveTopRight(r.topLeft());
+    }
+    else if (align == RightBottom) {
+        alignList << "Qt::AlignLeft" << "Qt::AlignBottom";
+        r.moveTopLeft(r.topRight());
+    }
+    else {
+        if (align & Top || (align & Bottom && align & Inside))
+            alignList << "Qt::AlignBottom";
+        else if (align & Bottom || (align & Top && align & Inside))
+            alignList << "Qt::AlignTop";
+        else
+            alignList << "Qt::AlignVCenter";
+        bool tb = align & (Top|Bottom);
+        if ((align & Left && !tb) || (align & Right && (align & Inside || tb)))
+            alignList << "Qt::AlignRight";
+        else if ((align & Right && !tb) || (align & Left && (align & Inside || tb)))
+            alignList << "Qt::AlignLeft";
+        else
+            alignList << "Qt::AlignHCenter";
+
+        if (outside) {
+            if (align & Top)
+                r.moveBottomLeft(r.topLeft());
+            else if (align & Bottom)
+                r.moveTopLeft(r.bottomLeft());
+            else if (align & Left)
+                r.moveTopRight(r.topLeft());
+            else if (align & Right)
+                r.moveTopLeft(r.topRight());
+        }
+    }
+    writeStartWidget(c, "QLabel", QString::Null(), r, attrs.text(Attributes::Label));
+    c.out.property("alignment", "set", alignList.join('|'));
+    writeEndWidget(c);
+    attrs.remove(Attributes::Label);
+}
+
+/// The element that contains the node
+const Element & parentElement(Context & c, const Node & n)
+{
+    auto const element = c.tree.parentElement(n);
+    return element ? *element : noElement;
+}
+
+void eFlBox(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+}
+
+void eFlGroup(Context & c, const Node & n)
+{
+    bool tabGroup = parentElement(c, n).kind == Kind::Tabs;
+    auto attrs = n.attrs;
+    if (true || tabGroup) {
+        if (attrs.has(Attributes::Label))
+            attrs.set(Attributes::Title, attrs.view(Attributes::Label));
+        attrs.remove(Attributes::Label);
+        writeStartWidget(c, "QWidget", attrs);
+    }
+    else {
+        warn(c) << "the non-tab group " << elide(attrs.text(Attributes::Name));
+        if (!attrs.text(Attributes::Label).isEmpty())
+            c.err << " labeled " << elide(attrs.text(Attributes::Label));
+        c.err << " under " << parentElement(c, n).name << " is a no-op." << endl;
+    }
+}
+
+void eFlGroupEnd(Context & c, const Node &)
+{
+    // every group is written as a widget; see eFlGroup
+    writeEndWidget(c);
+}
+
+void eFlTextDisplay(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "QTextBrowser", attrs);
+    writeEndWidget(c);
+}
+
+void eFlButton(Context & c, const Node & n)
+{
+    auto const & attrs = n.attrs;
+    writeStartWidget(c, "QPushButton", attrs);
+    if (n.element->kind == Kind::RepeatButton)
+        c.out.property("autoRepeat", "bool", "true");
+    writeEndWidget(c);
+}
+
+void eFlTabs(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "QTabWidget", attrs);
+}
+
+void eFlSlider(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    auto type = attrs.text(Attributes::Type);
+    genLabel(c, attrs);
+    writeStartWidget(c, "DoubleSlider", attrs);
+    if (type.isEmpty() || type == "Vert Knob") {
+        /* default orientation */
+    }
+    else if (type == "Horz Knob") {
+        writeOrientation(c.out, Qt::Horizontal);
+    }
+    else {
+        warn(c) << "unknown " << n.element->name << " type " << elide(attrs.text(Attributes::Type)) << endl;
+    }
+    writeEndWidget(c);
+}
+
+void eFlInput(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    auto type = attrs.text(Attributes::Type);
+    genLabel(c, attrs);
+    if (type.isEmpty()) {
+        writeStartWidget(c, "QLineEdit", attrs);
+        writeEndWidget(c);
+    }
+    else if (type == "Float") {
+        writeStartWidget(c, "QDoubleSpinBox", attrs);
+        c.out.property("buttonSymbols", "enum", "QAbstractSpinBox::NoButtons");
+        writeAttrProperty(c.out, "value", "double", attrs, Attributes::Value);
+        writeAttrProperty(c.out, "minimum", "double", attrs, Attributes::Minimum);
+        writeAttrProperty(c.out, "maximum", "double", attrs, Attributes::Maximum);
+        writeAttrProperty(c.out, "singleStep", "double", attrs, Attributes::Step);
+        writeEndWidget(c);
+    }
+    else if (type == "Int") {
+        writeStartWidget(c, "QSpinBox", attrs);
+        c.out.property("buttonSymbols", "enum", "QAbstractSpinBox::NoButtons");
+        writeAttrProperty(c.out, "value", "int", attrs, Attributes::Value);
+        writeAttrProperty(c.out, "minimum", "int", attrs, Attributes::Minimum);
+        writeAttrProperty(c.out, "maximum", "int", attrs, Attributes::Maximum);
+        writeAttrProperty(c.out, "singleStep", "int", attrs, Attributes::Step);
+        writeEndWidget(c);
+    }
+    else {
+        warn(c) << "unknown " << n.element->name << " type " << elide(type) << endl;
+    }
+}
+
+void eFlLightButton(Context & c, const Node & n)
+{
+    auto const & attrs = n.attrs;
+    writeStartWidget(c, "QCheckBox", attrs);
+    writeEndWidget(c);
+}
+
+void eFlChoice(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "QComboBox", attrs);
+}
+
+void emenuitem(Context & c, const Node & n)
+{
+    bool choice = parentElement(c, n).kind == Kind::Choice;
+    auto const & attrs = n.attrs;
+    if (choice) {
+        c.out.startItem();
+        writeAttrProperty(c.out, "text", "string", attrs, Attributes::Label);
+        c.out.endItem();
+    }
+    else {
+        warn(c) << "ignoring the menu item " << elide(attrs.text(Attributes::Name));
+        if (!attrs.text(Attributes::Label).isEmpty())
+            c.err << " labeled " << elide(attrs.text(Attributes::Label));
+        c.err << " under " << parentElement(c, n).name << "." << endl;
+    }
+}
+
+void eFlOutput(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "QLineEdit", attrs);
+    c.out.property("readOnly", "bool", "true");
+    writeEndWidget(c);
+}
+
+void eFlRoundButton(Context & c, const Node & n)
+{
+    auto const & attrs = n.attrs;
+    auto hasType = attrs.has(Attributes::Type);
+    auto type = attrs.text(Attributes::Type);
+    if (type == "Radio") {
+        writeStartWidget(c, "QRadioButton", attrs);
+        writeEndWidget(c);
+    }
+    else if (! hasType) {
+        // Toggle Button
+        writeStartWidget(c, "QRadioButton", attrs);
+        c.out.property("checkable", "bool", "true");
+        c.out.property("autoExclusive", "bool", "false");
+        writeEndWidget(c);
+    }
+    else {
+        warn(c) << "unknown " << n.element->name << " type " << elide(type) << endl;
+    }
+}
+
+void eFlBrowser(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    auto type = attrs.text(Attributes::Type);
+    if (type == "Hold" || type == "Multi") {
+        writeStartWidget(c, "QListWidget", attrs);
+        if (type == "Multi") {
+            c.out.property("selectionMode", "enum",
+                          "QAbstractItemView::MultiSelection");
+        }
+        writeEndWidget(c);
+    }
+    else {
+        warn(c) << "unknown " << n.element->name << " type " << elide(type) << endl;
+    }
+}
+
+void eFlTextEditor(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "QTextEdit", attrs);
+    writeEndWidget(c);
+}
+
+void eFlCheckButton(Context & c, const Node & n)
+{
+    auto const & attrs = n.attrs;
+    writeStartWidget(c, "QCheckBox", attrs);
+    if (attrs.toInt(Attributes::Value)) {
+        c.out.property("checked", "bool", "true");
+    }
+    writeEndWidget(c);
+}
+
+void eFlValueSlider(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "ValueSlider", attrs);
+    writeAttrProperty(c.out, "value", "double", attrs, Attributes::Value);
+    writeAttrProperty(c.out, "minimum", "double", attrs, Attributes::Minimum);
+    writeAttrProperty(c.out, "maximum", "double", attrs, Attributes::Maximum);
+    writeAttrProperty(c.out, "singleStep", "double", attrs, Attributes::Step);
+    if (attrs.text(Attributes::Type) == "Horz Knob") {
+        writeOrientation(c.out, Qt::Horizontal);
+    }
+    else {
+        warn(c) << "unknown " << n.element->name << " type " << elide(attrs.text(Attributes::Type)) << endl;
+    }
+    writeEndWidget(c);
+}
+
+void eFlCounter(Context & c, const Node & n)
+{
+    auto attrs = n.attrs;
+    genLabel(c, attrs);
+    writeStartWidget(c, "QSpinBox", attrs);
+    writeAttrProperty(c.out, "value", "double", attrs, Attributes::Value);
+    writeAttrProperty(c.out, "minimum", "double", attrs, Attributes::Minimum);
+    writeAttrProperty(c.out, "maximum", "double", attrs, Attributes::Maximum);
+    writeAttrProperty(c.out, "singleStep", "double", attrs, Attributes::Step);
+    writeEndWidget(c);
+}
+
+void eWindow(Context & c, const Node & n)
+{
+    auto const & attrs = n.attrs;
+    if (attrs.has(Attributes::Label))
+        c.out.property("windowTitle", "string", attrs.text(Attributes::Label));
+    writeGeometry(c.out, attrs.xywh());
+}
+
+void eClass(Context & c, const Node & n)
+{
+    QString const name = n.attrs.text(Attributes::Name);
+    c.out.startForm(name);
+    c.out.startWidget("QDialog", objectName(c, "QDialog", name));
+}
+
+void eClassEnd(Context & c, const Node &)
+{
+    c.out.endWidget();
+    c.out.endForm();
+}
+
+void writeCustomWidgets(Emitter & out)
+{
+    out.customWidget("DoubleSlider", "QSlider", "DoubleSlider.h");
+    out.customWidget("ValueSlider", "QSlider", "ValueSlider.h");
+}
+
+void eTopEnd(Context & c, const Node &)
+{
+    writeCustomWidgets(c.out);
+}
+
+/// The end of a container widget
+void eEndWidget(Context & c, const Node &)
+{
+    writeEndWidget(c);
+}
+
+void emitNode(Context & c, const Node & node)
+{
+    // the nodes whose children are being written, and the next child of
+    // each, so that the depth of the tree doesn't use up the native stack
+    QVector<QPair<const Node *, int>> open;
+    auto const start = [&](const Node & n) {
+        {
+            Span span(c, n.element->name, n.parent >= 0);
+            if (n.element->generate) n.element->generate(c, n);
+        }
+        open.append(qMakePair(&n, n.firstChild));
+    };
+    start(node);
+    while (! open.isEmpty()) {
+        int const child = open.last().second;
+        if (child < 0) {
+            const Node & n = *open.takeLast().first;
+            if (n.element->finish) n.element->finish(c, n);
+            continue;
+        }
+        open.last().second = c.tree.at(child).next;
+        start(c.tree.at(child));
+    }
+}
+
+void emitChildren(Context & c, const Node & n)
+{
+    for (int i = n.firstChild; i >= 0; i = c.tree.at(i).next)
+        emitNode(c, c.tree.at(i));
+}
+
+const Element pXYWHElement = { "pXYWH", Kind::Production, nullptr, nullptr, nullptr };
+const Element pAttributesElement = { "pAttributes", Kind::Production, nullptr, nullptr, nullptr };
+const Element pVisualsElement = { "pVisuals", Kind::Production, nullptr, nullptr, nullptr };
+const Element pWindowElement = { "Fl_Window", Kind::Window, nullptr, eWindow, nullptr };
+const Element pFunctionElement = { "Function", Kind::Production, nullptr, nullptr, nullptr };
+const Element pClassElement = { "class", Kind::Production, nullptr, eClass, eClassEnd };
+const Element pTopElement = { "pTop", Kind::Production, nullptr, nullptr, eTopEnd };
+const Element unknownElement = { "unknown visual element", Kind::Item, nullptr, nullptr, nullptr };
+
+QRect pXYWH(Context & c)
+{
+    Stacker s(c, pXYWHElement);
+    brace(c, '{');
+    int const x = word(c).toInt();
+    int const y = word(c).toInt();
+    int const w = word(c).toInt();
+    int const h = word(c).toInt();
+    brace(c, '}');
+    QRect r(x, y, w, h);
+    return r;
+}
+
+Attributes pAttributes(Context & c) {
+    Stacker s(c, pAttributesElement);
+    Attributes attrs;
+    forever {
+        auto const attr = token(c);
+        if (c.in.is(attr, '}')) break;
+        else if (c.in.is(attr, "open") || c.in.is(attr, "hide")
+                 || c.in.is(attr, "resizable") || c.in.is(attr, "visible")
+                 || c.in.is(attr, "selected")) c.in.discard(attr);
+        else if (c.in.is(attr, "xywh")) {
+            attrs.setXywh(pXYWH(c), c.topLeft.top());
+        }
+        else {
+            auto const val = token(c);
+            bool const early = c.in.is(val, '}');
+            if (early)
+                warn(c) << "attribute " << elide(c.in.text(attr)) << " ended early." << endl;
+            auto const key = Attributes::key(c.in, attr);
+            if (key != Attributes::KeyCount) {
+                attrs.set(key, c.in.slice(val, c.tree.arena));
+            }
+            else {
+                // no handler reads the other attributes
+                c.in.discard(attr);
+                c.in.discard(val);
+            }
+            if (early) break;
+        }
+    }
+    return attrs;
+}
+
+Attributes pItem(Context & c)
+{
+    auto const name = c.in.slice(token(c), c.tree.arena);
+    brace(c, '{');
+    Attributes attrs = pAttributes(c);
+    attrs.set(Attributes::Name, name);
+    return attrs;
+}
+
+/// Adds the element on top of the parse stack to the tree; returns its node
+int pNode(Context & c, const Attributes & attrs)
+{
+    if (c.tree.count() >= c.options.maxElements)
+        perr(c, QString("the document has more than %1 elements").arg(c.options.maxElements), 11);
+    Node n;
+    n.element = &c.top();
+    n.offset = c.frames.last().offset;
+    n.end = c.in.pos();
+    n.parent = c.parent;
+    n.attrs = attrs;
+    return c.tree.add(n);
+}
+
+/// An item without elements of its own
+void pLeaf(Context & c)
+{
+    pNode(c, pItem(c));
+}
+
+/// An item followed by the elements it contains, which pVisuals reads next
+void pContainer(Context & c)
+{
+    int const node = pNode(c, pItem(c));
+    brace(c, '{');
+    enter(c, node);
+}
+
+/// A group, whose elements are placed relative to it
+void pGroup(Context & c)
+{
+    int const node = pNode(c, pItem(c));
+    brace(c, '{');
+    enter(c, node, true);
+}
+
+/// The supported visual elements
+constexpr Element visuals[] = {
+    { "Fl_Box", Kind::Widget, pLeaf, eFlBox, nullptr },
+    { "Fl_Group", Kind::Widget, pGroup, eFlGroup, eFlGroupEnd },
+    { "Fl_Text_Display", Kind::Widget, pLeaf, eFlTextDisplay, nullptr },
+    { "Fl_Button", Kind::Widget, pLeaf, eFlButton, nullptr },
+    { "Fl_Repeat_Button", Kind::RepeatButton, pLeaf, eFlButton, nullptr },
+    { "Fl_Tabs", Kind::Tabs, pContainer, eFlTabs, eEndWidget },
+    { "Fl_Slider", Kind::Widget, pLeaf, eFlSlider, nullptr },
+    { "Fl_Input", Kind::Widget, pLeaf, eFlInput, nullptr },
+    { "Fl_Light_Button", Kind::Widget, pLeaf, eFlLightButton, nullptr },
+    { "Fl_Choice", Kind::Choice, pContainer, eFlChoice, eEndWidget },
+    { "Fl_Output", Kind::Widget, pLeaf, eFlOutput, nullptr },
+    { "Fl_Round_Button", Kind::Widget, pLeaf, eFlRoundButton, nullptr },
+    { "Fl_Browser", Kind::Widget, pLeaf, eFlBrowser, nullptr },
+    { "Fl_Text_Editor", Kind::Widget, pLeaf, eFlTextEditor, nullptr },
+    { "Fl_Check_Button", Kind::Widget, pLeaf, eFlCheckButton, nullptr },
+    { "Fl_Value_Slider", Kind::Widget, pLeaf, eFlValueSlider, nullptr },
+    { "Fl_Counter", Kind::Widget, pLeaf, eFlCounter, nullptr },
+    { "menuitem", Kind::Item, pLeaf, emenuitem, nullptr },
+    { "MenuItem", Kind::Item, pLeaf, emenuitem, nullptr },
+};
+
+constexpr auto visualsHash = makePerfectHash<64>(visuals);
+
+const Element * findVisual(const Lexer & in, const Token & t)
+{
+    QByteArray decoded;
+    const char * name = in.data() + t.offset;
+    int length = t.length;
+    if (t.escaped) {
+        decoded = in.text(t).toUtf8();
+        name = decoded.constData();
+        length = decoded.size();
+    }
+    int const i = visualsHash.find(name, length);
+    if (i < 0) return nullptr;
+    auto const & visual = visuals[i];
+    if (nameLength(visual.name) != length || memcmp(visual.name, name, length)) return nullptr;
+    return &visual;
+}
+
+void pVisual(Context & c, const Token & vis)
+{
+    if (auto visual = findVisual(c.in, vis)) {
+        if (auto stats = c.options.stats) ++stats->widgets[visual->name];
+        Stacker s(c, *visual);
+        visual->parse(c);
+    }
+    else {
+        if (auto stats = c.options.stats) ++stats->unknownElements;
+        Stacker s(c, unknownElement);
+        auto name = word(c);
+        c.in.discard(token(c));
+        warn(c) << "unknown visual element " << elide(c.in.text(vis)) << " named "  << elide(name) << endl;
+    }
+}
+
+/// Skips words up to the closing brace that returns to the given nesting
+/// level. Returns false at the end of input.
+bool resync(Context & c, int depth)
+{
+    while (c.depth > depth) {
+        auto const w = readWordDiag(c);
+        if (w.isNull()) return false;
+        c.in.discard(w);
+    }
+    return true;
+}
+
+void enter(Context & c, int node, bool relative)
+{
+    // the window holds the containers rather than being one of them
+    if (c.tree.at(node).element->kind != Kind::Window) {
+        if (c.nesting >= c.options.maxDepth)
+            perr(c, QString("the elements are nested more than %1 deep").arg(c.options.maxDepth), 11);
+        ++c.nesting;
+    }
+    c.levels.append({ node, c.parent, c.depth, c.frames.size() - 1, relative });
+    if (relative) c.topLeft.push(c.tree.at(node).attrs.sourceXywh().topLeft());
+    c.parent = node;
+}
+
+/// Closes the innermost open node, and pops it off the parse stack
+void leave(Context & c)
+{
+    Level const level = c.levels.takeLast();
+    if (c.tree.at(level.node).element->kind != Kind::Window) --c.nesting;
+    c.tree[level.node].end = c.in.pos();
+    if (level.relative) c.topLeft.pop();
+    c.parent = level.previous;
+    c.frames.resize(level.frame);
+}
+
+void pVisuals(Context & c)
+{
+    Stacker s(c, pVisualsElement);
+    // the containers among the elements are read in this loop rather than
+    // recursively, so that deep nesting doesn't use up the native stack
+    int const outermost = c.levels.size();
+    while (c.levels.size() >= outermost) {
+        auto vis = token(c);
+        if (c.in.startsWith(vis, '{')) {
+            warn(c) << "unexpected group" << endl;
+            vis = token(c);
+        }
+        if (c.in.is(vis, '}')) {
+            leave(c);
+            continue;
+        }
+        if (! c.options.recover) {
+            pVisual(c, vis);
+            continue;
+        }
+        try {
+            pVisual(c, vis);
+        }
+        catch (const ParseError & e) {
+            // past the element limit, each element that follows would fail too
+            if (c.tree.count() >= c.options.maxElements) throw;
+            c.err << "Error: " << e.describe();
+            if (! resync(c, c.levels.last().depth)) throw;
+            c.err << "Recovered, skipping the rest of " << elide(c.in.text(vis)) << endl;
+            ++c.recovered;
+        }
+    }
+}
+
+void pWindow(Context & c)
+{
+    Stacker s(c, pWindowElement);
+    token(c, "Fl_Window");
+    int const node = pNode(c, pItem(c));
+    brace(c, '{');
+    enter(c, node);
+    pVisuals(c);
+}
+
+void pFunction(Context & c)
+{
+    Stacker s(c, pFunctionElement);
+    token(c, "Function");
+    c.in.discard(token(c));
+    brace(c, '{');
+    pAttributes(c);
+    brace(c, '{');
+    pWindow(c);
+}
+
+void pTop(Context & c, int end)
+{
+    Stacker s(c, pTopElement);
+    c.tree[Tree::Root].element = &pTopElement;
+    c.topLeft << QPoint(0,0);
+    Token w;
+    while (c.in.pos() < end && !(w = readWordDiag(c)).isNull()) {
+        if (c.in.is(w, "class")) {
+            Span span(c, "class");
+            Node n;
+            n.element = &pClassElement;
+            n.offset = w.offset;
+            n.parent = c.parent;
+            n.attrs.set(Attributes::Name, c.in.slice(token(c), c.tree.arena));
+            if (c.trace) span.args["name"] = n.attrs.text(Attributes::Name);
+            brace(c, '{');
+            pAttributes(c);
+            int const node = c.tree.add(n);
+            Parent p(c, node);
+            brace(c, '{');
+            pFunction(c);
+            c.tree[node].end = c.in.pos();
+        }
+        else {
+            c.in.discard(w);
+            c.in.discard(token(c));
+        }
+    }
+}
+
+int pReread(Context & c, int node, int end)
+{
+    Node const old = c.tree.at(node);
+    int const size = c.tree.size();
+    int const lastChild = c.tree.at(old.parent).lastChild;
+    // the element is placed relative to the innermost group around it, and
+    // nested as deep as the containers around it
+    QPoint topLeft;
+    bool placed = false;
+    c.nesting = 0;
+    for (int i = old.parent; i >= 0; i = c.tree.at(i).parent) {
+        auto const parse = c.tree.at(i).element->parse;
+        if (parse == pGroup && ! placed) {
+            topLeft = c.tree.at(i).attrs.sourceXywh().topLeft();
+            placed = true;
+        }
+        if (parse == pGroup || parse == pContainer) ++c.nesting;
+    }
+    c.topLeft.clear();
+    c.topLeft << topLeft;
+    c.frames.clear();
+    c.levels.clear();
+    c.parent = old.parent;
+    c.depth = 0;
+    c.in.seek(old.offset);
+    bool read = false;
+    try {
+        Stacker s(c, *old.element);
+        old.element->parse(c);
+        // a container goes on with its elements
+        if (! c.levels.isEmpty()) pVisuals(c);
+        read = c.tree.size() > size && c.in.pos() == end;
+    }
+    catch (const ParseError &) {
+    }
+
+    // the new node was added as the last child of the parent
+    c.tree[lastChild].next = -1;
+    c.tree[old.parent].lastChild = lastChild;
+    if (! read) {
+        c.tree.truncate(size);
+        return -1;
+    }
+    c.tree.replace(node, size);
+    return size;
+}
+
+/// Adds the spans recorded so far to the trace, on the track of the
+/// current thread
+void addEvents(Context & c)
+{
+    if (! c.trace) return;
+    c.trace->add(c.events);
+    c.events.clear();
+}
+
+/// Adds the counters of a finished conversion to the stats, and its spans
+/// to the trace
+void account(Context & c, const QElapsedTimer & timer, const Stats & before)
+{
+    addEvents(c);
+    Stats * const stats = c.options.stats;
+    if (! stats) return;
+    stats->nsecs[Stats::Parse] += timer.nsecsElapsed()
+            - (stats->nsecs[Stats::Tokenize] - before.nsecs[Stats::Tokenize])
+            - (stats->nsecs[Stats::Generate] - before.nsecs[Stats::Generate])
+            - (stats->nsecs[Stats::Emit] - before.nsecs[Stats::Emit]);
+    stats->files += 1;
+    stats->bytes += c.in.size();
+    stats->materializedBytes += c.in.materializedBytes();
+    stats->skippedBytes += c.in.skippedBytes();
+    stats->warnings += c.warnings;
+}
+
+/// Sets the writer up to write within the ui element to the device, as if
+/// it had just written the start of the document. Its output begins with
+/// the '>' that closes the ui start tag.
+void startWithinUi(QXml & writer, QIODevice & device)
+{
+    QBuffer start;
+    start.open(QIODevice::WriteOnly);
+    writer.setDevice(&start);
+    UiEmitter(writer).startDocument();
+    writer.setDevice(&device);
+}
+
+/// A top-level class of a document, read into its own tree and written on
+/// its own thread
+struct Part {
+    Q_DISABLE_COPY(Part)
+    Part(const Lexer & source, int begin, int end, const ConvertOptions & options);
+    int const begin;
+    int const end;
+    Lexer in;
+    ConvertOptions options;
+    Stats stats;
+    QString diagnostics;
+    QBuffer ui;                 ///< the output within the ui element
+    QXml writer;
+    UiEmitter emitter;
+    Context c;
+    bool ok = false;            ///< read up to its end and no further
+    int parseDiagnostics = 0;   ///< the length of the diagnostics of the reading
+    int parseWarnings = 0;
+};
+
+Part::Part(const Lexer & source, int begin, int end, const ConvertOptions & options) :
+    begin(begin), end(end), in(source.data(), source.size()), options(options),
+    emitter(writer), c(in, emitter, &diagnostics, this->options)
+{
+    this->options.diagnostics = nullptr;
+    this->options.cache = nullptr;
+    this->options.scratch = nullptr;
+    if (options.stats) this->options.stats = &stats;
+    c.trace = options.trace;
+    c.recordNames = true;
+    ui.open(QIODevice::WriteOnly);
+    startWithinUi(writer, ui);
+}
+
+void readPart(Part & p)
+{
+    Context & c = p.c;
+    p.in.seek(p.begin);
+    try {
+        pTop(c, p.end);
+        p.ok = p.in.pos() == p.end;
+    }
+    catch (const ParseError &) {
+        // the whole document is read again, and reports the error
+    }
+    c.err.flush();
+    p.parseDiagnostics = p.diagnostics.size();
+    p.parseWarnings = c.warnings;
+    addEvents(c);
+}
+
+/// Writes the part, replacing what an earlier call wrote
+void generatePart(Part & p)
+{
+    Context & c = p.c;
+    c.err.flush();
+    p.diagnostics.truncate(p.parseDiagnostics);
+    c.warnings = p.parseWarnings;
+    c.warningAt.resize(p.parseWarnings);
+    p.ui.buffer().clear();
+    p.ui.seek(0);
+    emitChildren(c, c.tree.at(Tree::Root));
+    c.err.flush();
+    addEvents(c);
+}
+
+/// Gives out the part's object names again, in the order the whole
+/// document gives them out. Returns whether any came out different, and
+/// the part must be written again with the new names.
+bool renamePart(Context & c, Part & p)
+{
+    bool renamed = false;
+    for (auto & request : p.c.names) {
+        QString const name = objectName(c, request.class_, request.name);
+        if (name == request.result) continue;
+        request.result = name;
+        renamed = true;
+    }
+    if (renamed) p.c.replayedNames = 0;
+    return renamed;
+}
+
+/// Copies a part's output to the device. The '>' it begins with is left
+/// out once an earlier part has closed the ui start tag.
+bool copyPart(QIODevice & out, const QByteArray & ui, bool tagClosed)
+{
+    int const skip = tagClosed && ui.startsWith('>') ? 1 : 0;
+    return out.write(ui.constData() + skip, ui.size() - skip) == ui.size() - skip;
+}
+
+/// Splits a document with several top-level classes into a part for each
+/// class, and reads the parts on separate threads. Returns false when the
+/// document can't be split so, or a part doesn't read the same on its own;
+/// the document must then be read as a whole.
+bool readParts(Context & c, QVector<Part *> & parts)
+{
+    Span span(c, "parse");
+    // Reads whole blocks and pairs of words like pTop. A class ends with
+    // its body, once the part's own pTop ends there as well.
+    Lexer scan(c.in.data(), c.in.size());
+    QVector<qint64> sizes;
+    qint64 tokens = 0;
+    Token w;
+    while (!(w = scan.next()).isNull()) {
+        if (scan.is(w, "class")) {
+            // the name, the attributes and the body
+            for (int i = 0; i < 3; ++i)
+                if (scan.next().isNull()) return false;
+            parts.append(new Part(c.in, w.offset, scan.pos(), c.options));
+            sizes.append(scan.pos() - w.offset);
+        }
+        else {
+            Token const value = scan.next();
+            if (value.isNull()) return false;
+            scan.discard(w);
+            scan.discard(value);
+            tokens += 2;
+        }
+    }
+    if (parts.size() < 2) return false;
+    runParallel(sizes, c.options.threads, [&](int i){ readPart(*parts.at(i)); });
+    for (auto p : parts)
+        if (! p->ok) return false;
+
+    c.in.seek(scan.pos());
+    c.in.addCounts(scan);
+    Stats * const stats = c.options.stats;
+    if (stats) stats->tokens += tokens;
+    for (auto p : parts) {
+        c.err << p->diagnostics.left(p->parseDiagnostics);
+        c.warnings += p->parseWarnings;
+        c.recovered += p->c.recovered;
+        c.in.addCounts(p->in);
+        if (stats) {
+            // the parts overlap in time, so only the whole is timed
+            Stats counts = p->stats;
+            std::fill(counts.nsecs, counts.nsecs + Stats::PhaseCount, 0);
+            stats->add(counts);
+        }
+    }
+    deliver(c);
+    return true;
+}
+
+/// Writes the parts on separate threads, then copies them to the device
+/// in order, within the ui element. The parts are written again wherever
+/// the object names differ from those of a conversion of the whole
+/// document.
+bool writeParts(Context & c, QIODevice & out, const QVector<Part *> & parts)
+{
+    QVector<qint64> sizes;
+    for (auto p : parts) sizes.append(p->end - p->begin);
+    runParallel(sizes, c.options.threads, [&](int i){ generatePart(*parts.at(i)); });
+
+    QVector<int> renamed;
+    QVector<qint64> renamedSizes;
+    for (int i = 0; i < parts.size(); ++i) {
+        if (renamePart(c, *parts.at(i))) {
+            renamed.append(i);
+            renamedSizes.append(sizes.at(i));
+        }
+    }
+    runParallel(renamedSizes, c.options.threads, [&](int i){ generatePart(*parts.at(renamed.at(i))); });
+
+    bool written = true;
+    for (int i = 0; i < parts.size(); ++i) {
+        Part const & p = *parts.at(i);
+        c.err << p.diagnostics.mid(p.parseDiagnostics);
+        c.warnings += p.c.warnings - p.parseWarnings;
+        written = copyPart(out, p.ui.buffer(), i > 0) && written;
+    }
+    deliver(c);
+
+    QBuffer end;
+    end.open(QIODevice::WriteOnly);
+    QXml writer;
+    startWithinUi(writer, end);
+    UiEmitter emitter(writer);
+    writeCustomWidgets(emitter);
+    emitter.endDocument();
+    return copyPart(out, end.buffer(), true) && written;
+}
+
+Target::Target(const Output & output, QByteArray * buffer) :
+    format(output.format), sink(*output.device, buffer), writer(&sink)
+{
+    switch (format) {
+    case ConvertOptions::Ui: emitter.reset(new UiEmitter(writer)); break;
+    case ConvertOptions::Header: emitter.reset(new SetupUiEmitter(sink)); break;
+    case ConvertOptions::Inventory: emitter.reset(new InventoryEmitter(sink)); break;
+    case ConvertOptions::Warnings: emitter.reset(new WarningsEmitter(sink)); break;
+    }
+}
+
+/// Parses the whole document into the tree, then writes it to each target;
+/// returns the status of the conversion. Nothing is written when the parse
+/// fails. Documents with several top-level classes are converted a class per
+/// thread when the options allow more than one and the only target is a .ui
+/// document.
+int convertDocument(Context & c, const QVector<Target *> & targets)
+{
+    QVector<Part *> parts;
+    bool const parallel = c.options.threads > 1 && targets.size() == 1
+            && targets.first()->format == ConvertOptions::Ui && readParts(c, parts);
+    if (! parallel) {
+        try {
+            Span span(c, "parse");
+            pTop(c);
+        }
+        catch (const ParseError & e) {
+            qDeleteAll(parts);
+            c.err << e.describe();
+            return e.rc;
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    Stats * const stats = c.options.stats;
+    qint64 const emitBefore = stats ? stats->nsecs[Stats::Emit] : 0;
+    bool written = true;
+    {
+        Span span(c, "emit");
+        if (parallel) {
+            c.out.startDocument();
+            written = writeParts(c, targets.first()->sink, parts);
+        }
+        else {
+            generateTree(c);
+        }
+    }
+    qDeleteAll(parts);
+    if (stats)
+        stats->nsecs[Stats::Generate] += timer.nsecsElapsed()
+                - (stats->nsecs[Stats::Emit] - emitBefore);
+
+    for (auto t : targets)
+        if (! t->sink.drain()) written = false;
+    if (c.out.hasError() || ! written) {
+        c.err << "Error writing the output" << endl;
+        return 4;
+    }
+    return c.recovered ? 5 : 0;
+}
+
+/// Converts the source into each of the outputs without consulting the cache
+int convertSource(const Source & source, const QVector<Output> & outputs, QString & diagnostics,
+                  const ConvertOptions & options)
+{
+    QElapsedTimer timer;
+    timer.start();
+    Stats const before = options.stats ? *options.stats : Stats();
+    Lexer in(source);
+    QVector<Target *> targets;
+    MultiEmitter all;
+    for (auto const & output : outputs) {
+        // the first output gathers its chunks in the reused buffer
+        bool const reuse = targets.isEmpty() && options.scratch;
+        targets << new Target(output, reuse ? &options.scratch->output : nullptr);
+        if (options.stats) targets.last()->sink.setTimer(&options.stats->nsecs[Stats::Emit]);
+        all.add(*targets.last()->emitter);
+    }
+    Emitter & emitter = targets.size() == 1 ? *targets.first()->emitter : all;
+    Context c(in, emitter, &diagnostics, options);
+    c.trace = options.trace;
+
+    int rc;
+    {
+        Span span(c, "convert");
+        rc = convertDocument(c, targets);
+    }
+    deliver(c);
+    account(c, timer, before);
+    qDeleteAll(targets);
+    return rc;
+}
+
+/// Converts the source into the output in the format of the options
+/// without consulting the cache
+int convertSource(const Source & source, QIODevice & out, QString & diagnostics,
+                  const ConvertOptions & options)
+{
+    return convertSource(source, QVector<Output>{{ options.format, &out }}, diagnostics, options);
+}
+
+/// Adds a message to the diagnostics and passes it to the callback
+void report(QString & diagnostics, const ConvertOptions & options, const QString & message)
+{
+    diagnostics += message;
+    if (options.diagnostics) options.diagnostics(message);
+}
+
+int convert(const Source & source, QIODevice & out, QString & diagnostics,
+            const ConvertOptions & options)
+{
+    Cache * const cache = options.cache;
+    if (! cache) return convertSource(source, out, diagnostics, options);
+
+    QByteArray const key = Cache::key(source, options);
+    CacheEntry entry;
+    Stats * const stats = options.stats;
+    if (cache->lookup(key, entry)) {
+        if (stats) {
+            stats->cacheHits += 1;
+            stats->files += 1;
+            stats->bytes += source.size();
+            // each warning was delivered as a message of its own
+            for (auto const & message : entry.messages)
+                if (message.startsWith("Warning: ")) stats->warnings += 1;
+        }
+        for (auto const & message : entry.messages) report(diagnostics, options, message);
+        if (out.write(entry.ui) != entry.ui.size()) {
+            report(diagnostics, options, "Error writing the output\n");
+            return 4;
+        }
+        return entry.rc;
+    }
+    if (stats) stats->cacheMisses += 1;
+
+    // the output and the messages are gathered so that they can be stored
+    QByteArray local;
+    QByteArray & document = options.scratch ? options.scratch->document : local;
+    // truncating keeps the reserved capacity of a reused buffer
+    document.reserve(Sink::Capacity);
+    QBuffer buffer(&document);
+    buffer.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    ConvertOptions recording = options;
+    recording.diagnostics = [&](const QString & message) {
+        entry.messages << message;
+        if (options.diagnostics) options.diagnostics(message);
+    };
+    entry.rc = convertSource(source, buffer, diagnostics, recording);
+    if (entry.rc && entry.rc != 5) {
+        out.write(document);
+        return entry.rc;
+    }
+    entry.ui = document;
+    cache->store(key, entry);
+    if (out.write(entry.ui) != entry.ui.size()) {
+        report(diagnostics, options, "Error writing the output\n");
+        return 4;
+    }
+    return entry.rc;
+}
+
+int convert(const Source & source, const QVector<Output> & outputs, QString & diagnostics,
+            const ConvertOptions & options)
+{
+    if (outputs.size() == 1) {
+        ConvertOptions single = options;
+        single.format = outputs.first().format;
+        return convert(source, *outputs.first().device, diagnostics, single);
+    }
+    // the cache keeps a single output for each conversion
+    return convertSource(source, outputs, diagnostics, options);
+}
+
+int convert(const char * data, int size, QIODevice & out, const ConvertOptions & options)
+{
+    Source const source(data, size);
+    QString local;
+    QString & diagnostics = options.scratch ? options.scratch->diagnostics : local;
+    diagnostics.reserve(1024);
+    diagnostics.resize(0);
+    return convert(source, out, diagnostics, options);
+}
+
+int convert(const char * data, int size, const QVector<Output> & outputs, const ConvertOptions & options)
+{
+    Source const source(data, size);
+    QString local;
+    QString & diagnostics = options.scratch ? options.scratch->diagnostics : local;
+    diagnostics.reserve(1024);
+    diagnostics.resize(0);
+    return convert(source, outputs, diagnostics, options);
+}
@@ -0,0 +1,39 @@
+#ifndef FL2UI_CONVERT_H
+#define FL2UI_CONVERT_H
+
+#include <QString>
+#include <QStringList>
+#include "fl2ui.h"
+
+class QIODevice;
+class Source;
+
+/// A syntax error in the FLUID source
+struct ParseError {
+    QString message;
+    int rc = 10;            ///< the exit status for the error
+    int offset = 0;         ///< byte offset of the last word read
+    int line = 0;           ///< line of the last word read, from one
+    int column = 0;         ///< column of the last word read, from one
+    QString excerpt;        ///< the source line with a caret under the column
+    QStringList lastWords;  ///< the last words read, oldest first
+    QStringList stack;      ///< the parse stack, innermost first
+    /// The position and message, followed by the excerpt, the last words
+    /// read and the parse stack
+    QString describe() const;
+};
+
+/// Converts a FLUID document to a Qt .ui document: reads it into a widget
+/// tree, then writes the tree out as UTF-8. Each conversion has its own
+/// state, so conversions can run concurrently. Warnings and errors are
+/// appended to diagnostics. Returns zero on success, 5 when the document was
+/// converted past recovered errors, or the status of the error that stopped
+/// the conversion; the output is empty or incomplete in the last case.
+FL2UI_EXPORT int convert(const Source & source, QIODevice & out, QString & diagnostics,
+                         const ConvertOptions & options = ConvertOptions());
+
+/// Converts the document once into each of the outputs
+FL2UI_EXPORT int convert(const Source & source, const QVector<Output> & outputs, QString & diagnostics,
+                         const ConvertOptions & options = ConvertOptions());
+
+#endif // FL2UI_CONVERT_H
@@ -0,0 +1,170 @@
+#include "emitter.h"
+#include <QRect>
+#include <QXmlStreamWriter>
+
+void UiEmitter::startDocument()
+{
+    m_ui.setCodec("UTF-8");
+    m_ui.setAutoFormatting(true);
+    m_ui.setAutoFormattingIndent(1);
+    m_ui.writeStartDocument();
+    m_ui.writeStartElement("ui");
+    m_ui.writeAttribute("version", "4.0");
+}
+
+void UiEmitter::startForm(const QString & name)
+{
+    m_ui.writeTextElement("class", name);
+}
+
+void UiEmitter::startWidget(const QString & class_, const QString & name)
+{
+    m_ui.writeStartElement("widget");
+    m_ui.writeAttribute("class", class_);
+    m_ui.writeAttribute("name", name);
+}
+
+void UiEmitter::endWidget()
+{
+    m_ui.writeEndElement();
+}
+
+void UiEmitter::property(const QString & name, const QString & type, const QString & value)
+{
+    m_ui.writeStartElement("property");
+    m_ui.writeAttribute("name", name);
+    m_ui.writeTextElement(type, value);
+    m_ui.writeEndElement();
+}
+
+void UiEmitter::geometry(const QRect & r)
+{
+    m_ui.writeStartElement("property");
+    m_ui.writeAttribute("name", "geometry");
+    m_ui.writeStartElement("rect");
+    m_ui.setAutoFormatting(false);
+    m_ui.writeTextElement("x", QString::number(r.x()));
+    m_ui.writeTextElement("y", QString::number(r.y()));
+    m_ui.writeTextElement("width", QString::number(r.width()));
+    m_ui.writeTextElement("height", QString::number(r.height()));
+    m_ui.writeEndElement();
+    m_ui.setAutoFormatting(true);
+    m_ui.writeEndElement();
+}
+
+void UiEmitter::attribute(const QString & name, const QString & value)
+{
+    m_ui.writeStartElement("attribute");
+    m_ui.writeAttribute("name", name);
+    m_ui.writeTextElement("string", value);
+    m_ui.writeEndElement();
+}
+
+void UiEmitter::startItem()
+{
+    m_ui.writeStartElement("item");
+}
+
+void UiEmitter::endItem()
+{
+    m_ui.writeEndElement();
+}
+
+void UiEmitter::customWidget(const QString & class_, const QString & extends, const QString & header)
+{
+    if (! m_customWidgets) {
+        m_ui.writeStartElement("customwidgets");
+        m_customWidgets = true;
+    }
+    m_ui.writeStartElement("customwidget");
+    m_ui.writeTextElement("class", class_);
+    m_ui.writeTextElement("extends", extends);
+    m_ui.writeTextElement("header", header);
+    m_ui.writeEndElement();
+}
+
+void UiEmitter::endDocument()
+{
+    if (m_customWidgets) {
+        m_ui.writeEndElement();
+        m_customWidgets = false;
+    }
+    m_ui.writeEndDocument();
+}
+
+bool UiEmitter::hasError() const
+{
+    return m_ui.hasError();
+}
+
+void MultiEmitter::startDocument()
+{
+    for (auto e : m_emitters) e->startDocument();
+}
+
+void MultiEmitter::startForm(const QString & name)
+{
+    for (auto e : m_emitters) e->startForm(name);
+}
+
+void MultiEmitter::endForm()
+{
+    for (auto e : m_emitters) e->endForm();
+}
+
+void MultiEmitter::startWidget(const QString & class_, const QString & name)
+{
+    for (auto e : m_emitters) e->startWidget(class_, name);
+}
+
+void MultiEmitter::endWidget()
+{
+    for (auto e : m_emitters) e->endWidget();
+}
+
+void MultiEmitter::property(const QString & name, const QString & type, const QString & value)
+{
+    for (auto e : m_emitters) e->property(name, type, value);
+}
+
+void MultiEmitter::geometry(const QRect & r)
+{
+    for (auto e : m_emitters) e->geometry(r);
+}
+
+void MultiEmitter::attribute(const QString & name, const QString & value)
+{
+    for (auto e : m_emitters) e->attribute(name, value);
+}
+
+void MultiEmitter::startItem()
+{
+    for (auto e : m_emitters) e->startItem();
+}
+
+void MultiEmitter::endItem()
+{
+    for (auto e : m_emitters) e->endItem();
+}
+
+void MultiEmitter::customWidget(const QString & class_, const QString & extends, const QString & header)
+{
+    for (auto e : m_emitters) e->customWidget(class_, extends, header);
+}
+
+void MultiEmitter::warning(const QString & message)
+{
+    for (auto e : m_emitters) e->warning(message);
+}
+
+void MultiEmitter::endDocument()
+{
+    for (auto e : m_emitters) e->endDocument();
+}
+
+bool MultiEmitter::hasError() const
+{
+    for (auto e : m_emitters)
+        if (e->hasError()) return true;
+    return false;
+}
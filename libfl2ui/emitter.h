@@ -0,0 +1,93 @@
+#ifndef FL2UI_EMITTER_H
+#define FL2UI_EMITTER_H
+
+// The outputs of the converter. The generate handlers describe the widgets
+// of each class to an emitter, which writes them out in its own format.
+
+#include <QString>
+#include <QVector>
+
+class QRect;
+class QXmlStreamWriter;
+
+/// Receives a converted document in the order of the .ui elements
+class Emitter {
+public:
+    virtual ~Emitter() {}
+    virtual void startDocument() = 0;
+    /// Starts a top-level class, whose widget follows
+    virtual void startForm(const QString & name) = 0;
+    virtual void endForm() = 0;
+    virtual void startWidget(const QString & class_, const QString & name) = 0;
+    virtual void endWidget() = 0;
+    /// A property of the current widget or item. The type names the .ui
+    /// element of the value: string, bool, enum, set, int or double.
+    virtual void property(const QString & name, const QString & type, const QString & value) = 0;
+    virtual void geometry(const QRect & r) = 0;
+    /// An attribute of the current widget within its container, such as
+    /// the title of a tab
+    virtual void attribute(const QString & name, const QString & value) = 0;
+    /// Starts an entry of the current widget's list, such as a combo box's
+    virtual void startItem() = 0;
+    virtual void endItem() = 0;
+    /// Declares a class that extends a Qt widget; follows the forms
+    virtual void customWidget(const QString & class_, const QString & extends, const QString & header) = 0;
+    /// A warning about the document, without the "Warning: " prefix; the
+    /// warnings follow the custom widgets
+    virtual void warning(const QString & message) = 0;
+    virtual void endDocument() = 0;
+    virtual bool hasError() const = 0;
+};
+
+/// Writes a Qt Designer .ui document
+class UiEmitter : public Emitter {
+    Q_DISABLE_COPY(UiEmitter)
+public:
+    explicit UiEmitter(QXmlStreamWriter & ui) : m_ui(ui) {}
+    QXmlStreamWriter & writer() { return m_ui; }
+    void startDocument() override;
+    void startForm(const QString & name) override;
+    void endForm() override {}
+    void startWidget(const QString & class_, const QString & name) override;
+    void endWidget() override;
+    void property(const QString & name, const QString & type, const QString & value) override;
+    void geometry(const QRect & r) override;
+    void attribute(const QString & name, const QString & value) override;
+    void startItem() override;
+    void endItem() override;
+    void customWidget(const QString & class_, const QString & extends, const QString & header) override;
+    void warning(const QString &) override {}
+    void endDocument() override;
+    bool hasError() const override;
+private:
+    QXmlStreamWriter & m_ui;
+    bool m_customWidgets = false;   ///< the customwidgets element is open
+};
+
+/// Passes the document on to several emitters, so that one conversion
+/// writes several outputs
+class MultiEmitter : public Emitter {
+    Q_DISABLE_COPY(MultiEmitter)
+public:
+    MultiEmitter() {}
+    void add(Emitter & emitter) { m_emitters.append(&emitter); }
+    void clear() { m_emitters.clear(); }
+    void startDocument() override;
+    void startForm(const QString & name) override;
+    void endForm() override;
+    void startWidget(const QString & class_, const QString & name) override;
+    void endWidget() override;
+    void property(const QString & name, const QString & type, const QString & value) override;
+    void geometry(const QRect & r) override;
+    void attribute(const QString & name, const QString & value) override;
+    void startItem() override;
+    void endItem() override;
+    void customWidget(const QString & class_, const QString & extends, const QString & header) override;
+    void warning(const QString & message) override;
+    void endDocument() override;
+    bool hasError() const override;
+private:
+    QVector<Emitter *> m_emitters;
+};
+
+#endif // FL2UI_EMITTER_H
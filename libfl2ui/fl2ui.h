@@ -0,0 +1,105 @@
+#ifndef FL2UI_FL2UI_H
+#define FL2UI_FL2UI_H
+
+// The public interface of libfl2ui, which converts FLUID .fl documents to
+// Qt .ui documents. Conversions share no state, so any number of threads
+// can convert at the same time.
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+/// The converter version. It is part of the cache key, so it must change
+/// whenever the output for some input changes.
+#define FL2UI_VERSION "1.2"
+
+#if defined(FL2UI_SHARED) && defined(FL2UI_BUILD)
+#  define FL2UI_EXPORT Q_DECL_EXPORT
+#elif defined(FL2UI_SHARED)
+#  define FL2UI_EXPORT Q_DECL_IMPORT
+#else
+#  define FL2UI_EXPORT
+#endif
+
+class QIODevice;
+struct Stats;
+class Trace;
+class Cache;
+
+/// Buffers that one thread reuses from one conversion to the next, rather
+/// than allocating them for each. A thread may only use its own.
+struct Scratch {
+    QByteArray output;      ///< gathers the output into chunks
+    QByteArray document;    ///< holds the whole output when it's cached
+    QString diagnostics;    ///< the messages, when the caller takes none
+};
+
+struct ConvertOptions {
+    /// The kinds of documents written
+    enum Format {
+        Ui,         ///< a Qt Designer .ui document
+        Header,     ///< a C++ header with the code uic generates from the .ui
+        Inventory,  ///< a JSON list of the widgets of each form
+        Warnings    ///< the warnings about the document, one per line
+    };
+    Format format = Ui;
+    /// Skip a malformed visual element up to the closing brace at its own
+    /// nesting level and carry on with the rest of the document
+    bool recover = false;
+    /// Accumulates timings and counters when set
+    Stats * stats = nullptr;
+    /// Receives a span for the conversion, each class and each visual
+    /// element when set
+    Trace * trace = nullptr;
+    /// Returns the stored output of an identical conversion instead of
+    /// converting again, and stores the output of new conversions, when set
+    Cache * cache = nullptr;
+    /// Leave an output file untouched when it already has the converted
+    /// contents, so that its modification time only changes with them
+    bool onlyIfChanged = false;
+    /// Receives each warning or error as soon as it's complete, on the
+    /// converting thread, when set
+    std::function<void(const QString & message)> diagnostics;
+    /// Buffers to reuse; each conversion allocates its own when unset
+    Scratch * scratch = nullptr;
+    /// Converts the top-level classes of a document on up to this many
+    /// threads when writing a .ui document, with the same output as one;
+    /// tokenizing within the classes then counts as parsing in the stats
+    int threads = 1;
+    /// The deepest nesting of groups, tabs and choices within a window that
+    /// is read; deeper elements are an error with status 11
+    int maxDepth = 100000;
+    /// The most elements that are read; the element past it is an error
+    /// with status 11 that isn't recovered from
+    int maxElements = 1000000;
+};
+
+/// Converts the FLUID document of the given size, writing the UTF-8 .ui
+/// document, or header, to the device once the whole input has been read.
+/// The input isn't copied. Returns zero on success, 5 when the document was
+/// converted past recovered errors, or the status of the error that stopped
+/// the conversion; the output is empty or incomplete in the last case.
+FL2UI_EXPORT int convert(const char * data, int size, QIODevice & out,
+                         const ConvertOptions & options = ConvertOptions());
+
+inline int convert(const QByteArray & in, QIODevice & out,
+                   const ConvertOptions & options = ConvertOptions())
+{
+    return convert(in.constData(), in.size(), out, options);
+}
+
+/// A document written by a conversion with several outputs
+struct Output {
+    ConvertOptions::Format format;
+    QIODevice * device;
+};
+
+/// Converts the FLUID document as above, but parses it once and writes each
+/// of the outputs in the same pass over the widgets; the format option is
+/// ignored. Only conversions with a single output are cached or converted
+/// on several threads.
+FL2UI_EXPORT int convert(const char * data, int size, const QVector<Output> & outputs,
+                         const ConvertOptions & options = ConvertOptions());
+
+#endif // FL2UI_FL2UI_H
@@ -0,0 +1,58 @@
+#include "ir.h"
+
+Tree::Tree()
+{
+    // truncating keeps the reserved capacity
+    m_nodes.reserve(256);
+    m_nodes.append(Node());
+}
+
+int Tree::add(const Node & node)
+{
+    int const i = m_nodes.size();
+    m_nodes.append(node);
+    Node & n = m_nodes.last();
+    n.firstChild = n.lastChild = n.next = -1;
+    if (n.parent >= 0) {
+        Node & parent = m_nodes[n.parent];
+        if (parent.lastChild >= 0) m_nodes[parent.lastChild].next = i;
+        else parent.firstChild = i;
+        parent.lastChild = i;
+    }
+    return i;
+}
+
+void Tree::replace(int node, int with)
+{
+    Node const old = m_nodes.at(node);
+    Node & parent = m_nodes[old.parent];
+    m_nodes[with].next = old.next;
+    if (parent.lastChild == node) parent.lastChild = with;
+    if (parent.firstChild == node) {
+        parent.firstChild = with;
+    }
+    else {
+        int i = parent.firstChild;
+        while (m_nodes.at(i).next != node) i = m_nodes.at(i).next;
+        m_nodes[i].next = with;
+    }
+    // counts the replaced nodes without recursing, as deep as they go
+    int i = node;
+    do {
+        ++m_dead;
+        if (m_nodes.at(i).firstChild >= 0) {
+            i = m_nodes.at(i).firstChild;
+            continue;
+        }
+        while (i != node && m_nodes.at(i).next < 0) i = m_nodes.at(i).parent;
+        i = i == node ? -1 : m_nodes.at(i).next;
+    } while (i >= 0);
+}
+
+void Tree::clear()
+{
+    m_dead = 0;
+    m_nodes.resize(1);
+    m_nodes[Root] = Node();
+    arena.reset();
+}
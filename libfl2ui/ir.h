@@ -0,0 +1,62 @@
+#ifndef FL2UI_IR_H
+#define FL2UI_IR_H
+
+// The widget tree: the parser builds it and the emitters walk it
+
+#include <QVector>
+#include "arena.h"
+#include "attributes.h"
+
+struct Element;
+
+/// An element of the document with its attributes. Nodes refer to each
+/// other by index into the tree.
+struct Node {
+    const Element * element = nullptr;
+    int offset = 0;             ///< where the element starts in the source
+    int end = 0;                ///< where it ends in the source, past its last brace
+    int parent = -1;
+    int firstChild = -1;
+    int lastChild = -1;
+    int next = -1;              ///< the next sibling
+    Attributes attrs;
+};
+Q_DECLARE_TYPEINFO(Node, Q_MOVABLE_TYPE);
+
+/// The nodes of a document, kept in one array in the order they were read,
+/// and the text they own in an arena. Nodes that are replaced stay in the
+/// array, dead, and clearing the tree frees it all.
+class Tree {
+    Q_DISABLE_COPY(Tree)
+public:
+    /// The root node, which stands for the whole document
+    enum { Root = 0 };
+    Tree();
+    /// Adds the node as the last child of its parent; returns its index
+    int add(const Node & node);
+    const Node & at(int i) const { return m_nodes.at(i); }
+    Node & operator[](int i) { return m_nodes[i]; }
+    int size() const { return m_nodes.size(); }
+    /// The nodes that are part of the document
+    int count() const { return m_nodes.size() - m_dead; }
+    /// The nodes that were replaced
+    int dead() const { return m_dead; }
+    /// The element of the node's parent
+    const Element * parentElement(const Node & node) const {
+        return node.parent >= 0 ? m_nodes.at(node.parent).element : nullptr;
+    }
+    /// Removes the nodes from the given index on. The nodes that stay must
+    /// not refer to them.
+    void truncate(int size) { m_nodes.resize(size); }
+    /// Puts the node, which has no siblings yet, in the place of the other
+    /// among its siblings; the other and the nodes within it are dead
+    void replace(int node, int with);
+    /// Removes all but the root node, and frees the text
+    void clear();
+    Arena arena;
+private:
+    QVector<Node> m_nodes;
+    int m_dead = 0;
+};
+
+#endif // FL2UI_IR_H
@@ -0,0 +1,44 @@
+# The sources of libfl2ui, for projects that build them in
+
+INCLUDEPATH += $$PWD
+
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    $$PWD/arena.cpp \
+    $$PWD/attributes.cpp \
+    $$PWD/batch.cpp \
+    $$PWD/cache.cpp \
+    $$PWD/census.cpp \
+    $$PWD/convert.cpp \
+    $$PWD/emitter.cpp \
+    $$PWD/ir.cpp \
+    $$PWD/live.cpp \
+    $$PWD/read.cpp \
+    $$PWD/reports.cpp \
+    $$PWD/scan.cpp \
+    $$PWD/setupui.cpp \
+    $$PWD/sink.cpp \
+    $$PWD/stats.cpp \
+    $$PWD/trace.cpp
+
+HEADERS += \
+    $$PWD/arena.h \
+    $$PWD/attributes.h \
+    $$PWD/batch.h \
+    $$PWD/cache.h \
+    $$PWD/census.h \
+    $$PWD/convert.h \
+    $$PWD/emitter.h \
+    $$PWD/fl2ui.h \
+    $$PWD/ir.h \
+    $$PWD/live.h \
+    $$PWD/parser.h \
+    $$PWD/perfecthash.h \
+    $$PWD/read.h \
+    $$PWD/reports.h \
+    $$PWD/scan.h \
+    $$PWD/setupui.h \
+    $$PWD/sink.h \
+    $$PWD/stats.h \
+    $$PWD/trace.h
@@ -0,0 +1,14 @@
+QT       += core
+QT       -= gui
+
+TARGET = fl2ui
+CONFIG   += c++14
+
+TEMPLATE = lib
+
+# a static library, or a shared one when configured with CONFIG+=fl2ui_shared
+fl2ui_shared: DEFINES += FL2UI_SHARED
+else: CONFIG += staticlib
+DEFINES += FL2UI_BUILD
+
+include(libfl2ui.pri)
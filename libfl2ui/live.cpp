@@ -0,0 +1,211 @@
+#include "live.h"
+#include "convert.h"
+#include "parser.h"
+
+struct LiveDocument::State {
+    explicit State(const ConvertOptions & options);
+    /// Reads the whole text
+    void readAll();
+    /// Forgets the messages of the last reading
+    void clearDiagnostics();
+
+    ConvertOptions options;
+    QByteArray text;
+    Lexer in;
+    MultiEmitter out;
+    QString diagnostics;
+    Context c;
+    int rc = 1;                 ///< the status of the last reading
+    int readDiagnostics = 0;    ///< the length of the diagnostics of the reading
+    int readWarnings = 0;
+    int firstChanged = -1;      ///< the first node of the last edit, if incremental
+};
+
+LiveDocument::State::State(const ConvertOptions & options) :
+    options(options), in(nullptr, 0), c(in, out, &diagnostics, this->options)
+{
+    // a live document has no use for the conversion-wide helpers
+    this->options.stats = nullptr;
+    this->options.trace = nullptr;
+    this->options.cache = nullptr;
+    this->options.scratch = nullptr;
+    this->options.diagnostics = nullptr;
+}
+
+void LiveDocument::State::clearDiagnostics()
+{
+    c.err.flush();
+    diagnostics.clear();
+    c.warnings = 0;
+    c.warningAt.clear();
+    c.recovered = 0;
+}
+
+void LiveDocument::State::readAll()
+{
+    c.tree.clear();
+    c.frames.clear();
+    c.levels.clear();
+    c.nesting = 0;
+    c.topLeft.clear();
+    c.parent = Tree::Root;
+    c.depth = 0;
+    c.recentCount = 0;
+    in.seek(0);
+    firstChanged = -1;
+    try {
+        pTop(c);
+        rc = c.recovered ? 5 : 0;
+    }
+    catch (const ParseError & e) {
+        c.err << e.describe();
+        rc = e.rc;
+    }
+}
+
+LiveDocument::LiveDocument(const ConvertOptions & options) : d(new State(options))
+{
+}
+
+LiveDocument::~LiveDocument()
+{
+}
+
+int LiveDocument::open(const QByteArray & text)
+{
+    d->text = text;
+    d->in = Lexer(d->text.constData(), d->text.size());
+    d->clearDiagnostics();
+    d->readAll();
+    d->c.err.flush();
+    d->readDiagnostics = d->diagnostics.size();
+    d->readWarnings = d->c.warnings;
+    return d->rc;
+}
+
+int LiveDocument::edit(int offset, int removed, const QByteArray & inserted)
+{
+    State & s = *d;
+    Context & c = s.c;
+    if (offset < 0 || removed < 0 || offset > s.text.size() - removed) {
+        c.err << "The edit is outside the document" << endl;
+        return 1;
+    }
+    int const editEnd = offset + removed;
+    int const delta = inserted.size() - removed;
+
+    // the elements around the edit, innermost first, that can be read again.
+    // The diagnostics of the elements that aren't would be lost, so a
+    // document whose reading had any is read again as a whole; so is one
+    // once the nodes that rereading replaced outnumber it, which frees them.
+    QVector<int> around;
+    bool const kept = s.rc == 0 && ! s.readDiagnostics && c.tree.dead() <= c.tree.count();
+    for (int i = kept ? c.tree.at(Tree::Root).firstChild : -1; i >= 0; ) {
+        Node const & n = c.tree.at(i);
+        if (n.offset < offset && editEnd <= n.end) {
+            if (n.element->parse) around.prepend(i);
+            i = n.firstChild;
+        }
+        else {
+            i = n.next;
+        }
+    }
+
+    QByteArray text;
+    text.reserve(s.text.size() + delta);
+    text.append(s.text.constData(), offset);
+    text.append(inserted);
+    text.append(s.text.constData() + editEnd, s.text.size() - editEnd);
+    // the kept nodes move along with the text after the edit; the dead ones
+    // are never looked at again
+    for (int i = kept ? int(Tree::Root) : -1; i >= 0; ) {
+        Node & n = c.tree[i];
+        n.attrs.rebase(s.text.constData(), s.text.size(), text.constData(), editEnd, delta);
+        if (n.offset >= editEnd) n.offset += delta;
+        if (n.end >= editEnd) n.end += delta;
+        if (n.firstChild >= 0) {
+            i = n.firstChild;
+            continue;
+        }
+        while (i >= 0 && c.tree.at(i).next < 0) i = c.tree.at(i).parent;
+        if (i >= 0) i = c.tree.at(i).next;
+    }
+    s.text.swap(text);
+    s.in = Lexer(s.text.constData(), s.text.size());
+
+    s.firstChanged = -1;
+    for (int const node : around) {
+        s.clearDiagnostics();
+        int const first = c.tree.size();
+        if (pReread(c, node, c.tree.at(node).end) >= 0) {
+            s.firstChanged = first;
+            break;
+        }
+    }
+    // an error recovered from is described with the parse stack and the
+    // words read before it, which only a whole reading gets right
+    if (s.firstChanged >= 0 && ! c.recovered) {
+        s.rc = 0;
+    }
+    else {
+        s.clearDiagnostics();
+        s.readAll();
+    }
+    c.err.flush();
+    s.readDiagnostics = s.diagnostics.size();
+    s.readWarnings = c.warnings;
+    return s.rc;
+}
+
+int LiveDocument::write(QIODevice & out, ConvertOptions::Format format)
+{
+    State & s = *d;
+    Context & c = s.c;
+    c.err.flush();
+    s.diagnostics.truncate(s.readDiagnostics);
+    c.warnings = s.readWarnings;
+    c.warningAt.resize(s.readWarnings);
+    if (s.rc && s.rc != 5) return s.rc;
+
+    // object names are given out afresh in document order
+    c.objectNameCounter.clear();
+    c.objectNames.clear();
+    Target target({ format, &out }, nullptr);
+    s.out.clear();
+    s.out.add(*target.emitter);
+    generateTree(c);
+    s.out.clear();
+    if (target.emitter->hasError() || ! target.sink.drain()) {
+        c.err << "Error writing the output" << endl;
+        return 4;
+    }
+    return s.rc;
+}
+
+const QByteArray & LiveDocument::text() const
+{
+    return d->text;
+}
+
+bool LiveDocument::wasIncremental() const
+{
+    return d->firstChanged >= 0;
+}
+
+QStringList LiveDocument::changed() const
+{
+    QStringList rv;
+    Tree const & tree = d->c.tree;
+    for (int i = qMax(d->firstChanged, 0); i < tree.size(); ++i) {
+        Node const & n = tree.at(i);
+        if (! n.element || ! n.element->parse) continue;
+        QString const name = n.attrs.text(Attributes::Name);
+        rv << (name.isEmpty() ? QString(n.element->name) : name);
+    }
+    return rv;
+}
+
+const QString & LiveDocument::diagnostics() const
+{
+    return d->diagnostics;
+}
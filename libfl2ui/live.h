@@ -0,0 +1,47 @@
+#ifndef FL2UI_LIVE_H
+#define FL2UI_LIVE_H
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QStringList>
+#include "fl2ui.h"
+
+class QIODevice;
+
+/// A document kept read between edits, for an editor with a live preview.
+/// An edit reads again only the innermost visual element around it, as long
+/// as that element still ends where it did, moved by the edit; otherwise it
+/// tries the elements around that one, and then the whole document. The
+/// whole document is also read again when its last reading had warnings or
+/// errors, so that the diagnostics stay those of a whole reading, and once
+/// the elements that edits replaced outnumber it. Writing walks the kept
+/// tree without reading the source again.
+class FL2UI_EXPORT LiveDocument {
+    Q_DISABLE_COPY(LiveDocument)
+public:
+    explicit LiveDocument(const ConvertOptions & options = ConvertOptions());
+    ~LiveDocument();
+    /// Reads the whole document; returns the status of the reading
+    int open(const QByteArray & text);
+    /// Replaces the removed bytes at offset with the inserted ones, and
+    /// reads what the edit changed; returns the status of the reading
+    int edit(int offset, int removed, const QByteArray & inserted);
+    /// Writes the document as read in the format; returns the status of the
+    /// conversion
+    int write(QIODevice & out, ConvertOptions::Format format = ConvertOptions::Ui);
+    const QByteArray & text() const;
+    /// Whether the last edit read only part of the document
+    bool wasIncremental() const;
+    /// The names of the visual elements that the last edit read again, in
+    /// document order; the class stands for an element without a name.
+    /// Every element changed after a full read.
+    QStringList changed() const;
+    /// The warnings and errors of the last reading, and of the last writing
+    /// since
+    const QString & diagnostics() const;
+private:
+    struct State;
+    QScopedPointer<State> d;
+};
+
+#endif // FL2UI_LIVE_H
@@ -0,0 +1,203 @@
+#ifndef FL2UI_PARSER_H
+#define FL2UI_PARSER_H
+
+// The internals of the FLUID parser and the .ui emitter, shared by the
+// converter and the benchmarks. The parser reads the document into a tree,
+// which the emitter then writes out.
+
+#include <QTextStream>
+#include <QXmlStreamWriter>
+#include <QStack>
+#include <QPoint>
+#include <QMap>
+#include <QSet>
+#include <QScopedPointer>
+#include <climits>
+#include "emitter.h"
+#include "ir.h"
+#include "read.h"
+#include "sink.h"
+#include "trace.h"
+
+class Attributes;
+struct ConvertOptions;
+
+typedef QXmlStreamWriter QXml;
+
+/// The kinds of elements on the parse stack
+enum class Kind : quint8 {
+    Production,     ///< a parser function
+    Item,           ///< a visual element that isn't a widget
+    Widget,         ///< any widget without a kind of its own
+    Window, Tabs, Choice, RepeatButton
+};
+
+struct Context;
+class Span;
+
+/// An element being parsed: a widget class or a parser production
+struct Element {
+    const char * name;
+    Kind kind;
+    /// Reads the element into the tree
+    void (*parse)(Context & c);
+    /// Writes the element's node out, up to its children
+    void (*generate)(Context & c, const Node & node);
+    /// Writes what follows the children of the element's node, if anything
+    void (*finish)(Context & c, const Node & node);
+    bool isWidget() const { return kind >= Kind::Widget; }
+};
+
+extern const Element noElement;
+
+/// An element on the parse stack, and where it starts in the source
+struct Frame {
+    const Element * element;
+    int offset;
+};
+
+/// A container whose elements are being read
+struct Level {
+    int node;           ///< the node that the elements are added to
+    int previous;       ///< the node that elements were added to before
+    int depth;          ///< the brace nesting level within the container
+    int frame;          ///< the container's frame, which stays on the parse stack
+    bool relative;      ///< its elements are placed relative to it
+};
+
+/// An object name that was given out, and the name asked for
+struct NameRequest {
+    QString class_;
+    QString name;
+    QString result;
+};
+
+/// The state of a single conversion
+struct Context {
+    Context(Lexer & in, Emitter & out, QString * diagnostics, const ConvertOptions & options) :
+        in(in), out(out), err(diagnostics), options(options), delivered(diagnostics->size()) {}
+    Lexer & in;
+    Emitter & out;
+    QTextStream err;
+    const ConvertOptions & options;
+    int delivered;          ///< diagnostics passed to the callback so far
+    int depth = 0;          ///< nesting level of the braces read
+    int recovered = 0;      ///< errors the parser recovered from
+    int warnings = 0;
+    QVector<int> warningAt;         ///< where each warning's message starts in the diagnostics
+    enum { RecentTokens = 8 };
+    QVector<Frame> frames;          ///< the parse stack
+    QVector<Level> levels;          ///< the open containers, outermost first
+    int nesting = 0;                ///< the open groups, tabs and choices, held to maxDepth
+    Token recent[RecentTokens];     ///< the last tokens read, as a ring
+    unsigned recentCount = 0;
+    Tree tree;                      ///< the document read so far
+    int parent = Tree::Root;        ///< the node that elements are added to
+    QStack<QPoint> topLeft;
+    QMap<QString, int> objectNameCounter;
+    QSet<QString> objectNames;
+    bool recordNames = false;       ///< keeps each name given out in names
+    int replayedNames = -1;         ///< when not negative, the next of names to give out again
+    QVector<NameRequest> names;
+    Trace * trace = nullptr;        ///< receives the spans when tracing is on
+    QVector<TraceEvent> events;     ///< spans not yet added to the trace
+    Span * span = nullptr;          ///< the innermost open span
+
+    /// The element on top of the parse stack
+    const Element & top() const { return *frames.last().element; }
+};
+
+/// Throws a ParseError that describes where the parser is
+Q_NORETURN void perr(Context & c, const QString & msg, int rc = 10);
+
+/// Records a span of the conversion for its lifetime when tracing is on
+class Span {
+    Q_DISABLE_COPY(Span)
+public:
+    Span(Context & c, const char * name, bool enabled = true) : c(c) {
+        if (enabled && c.trace) begin(name);
+    }
+    ~Span() {
+        if (m_name) end();
+    }
+    /// Names the widget written within the span, unless it's named already
+    void setWidget(const QString & class_, const QString & name);
+    QJsonObject args;
+private:
+    void begin(const char * name);
+    void end();
+    Context & c;
+    const char * m_name = nullptr;
+    Span * m_parent = nullptr;
+    qint64 m_start = 0;
+    int m_pos = 0;
+};
+
+/// Keeps an element on the parse stack for its lifetime, unless the element
+/// is a container whose elements are still to be read; leave() pops it then
+class Stacker {
+    Q_DISABLE_COPY(Stacker)
+    Context & c;
+    Span span;
+    int const index;
+public:
+    Stacker(Context & c, const Element & item) :
+        c(c), span(c, item.name, item.parse != nullptr), index(c.frames.size()) {
+        c.frames.append({ &item, c.in.pos() });
+    }
+    ~Stacker() {
+        bool const open = ! c.levels.isEmpty() && c.levels.last().frame == index;
+        if (! open && c.frames.size() > index) c.frames.resize(index);
+    }
+};
+
+/// Adds the elements read during its lifetime to the given node
+class Parent {
+    Q_DISABLE_COPY(Parent)
+    Context & c;
+    int const previous;
+public:
+    Parent(Context & c, int node) : c(c), previous(c.parent) { c.parent = node; }
+    ~Parent() { c.parent = previous; }
+};
+
+/// The supported visual element named by the token, if any
+const Element * findVisual(const Lexer & in, const Token & t);
+/// Reads the attributes of an item up to the closing brace
+Attributes pAttributes(Context & c);
+/// Opens the node, which is on top of the parse stack, past its opening
+/// brace: the elements read next are added to it
+void enter(Context & c, int node, bool relative = false);
+/// Reads the elements of the open node up to its closing brace, along with
+/// those of the containers among them, and closes it
+void pVisuals(Context & c);
+/// Reads a whole document into the tree, or its top-level elements up to
+/// the given offset
+void pTop(Context & c, int end = INT_MAX);
+/// Reads the visual element of the node again, from where it starts in the
+/// source, and puts it in the node's place. Returns the new node, or -1 if
+/// the element doesn't read or doesn't end at end; the tree is unchanged
+/// then.
+int pReread(Context & c, int node, int end);
+
+/// Generate a label for an item that could have an optional label
+void genLabel(Context & c, Attributes & attrs);
+/// Writes a node and its children
+void emitNode(Context & c, const Node & node);
+/// Writes the children of a node in order
+void emitChildren(Context & c, const Node & node);
+/// Writes the whole tree to the context's emitter, followed by the warnings
+void generateTree(Context & c);
+
+/// An output of a conversion: the sink that gathers it, and the emitter that
+/// writes it in its format
+struct Target {
+    Q_DISABLE_COPY(Target)
+    Target(const Output & output, QByteArray * buffer);
+    ConvertOptions::Format const format;
+    Sink sink;
+    QXml writer;
+    QScopedPointer<Emitter> emitter;
+};
+
+#endif // FL2UI_PARSER_H
@@ -0,0 +1,61 @@
+#ifndef FL2UI_PERFECTHASH_H
+#define FL2UI_PERFECTHASH_H
+
+#include <QtGlobal>
+
+// A perfect hash over a constant table of named entries, found at compile
+// time. Each name maps to its own slot, so a lookup is one probe and one
+// comparison.
+
+constexpr int nameLength(const char * name)
+{
+    int n = 0;
+    while (name[n]) ++n;
+    return n;
+}
+
+constexpr quint32 nameHash(const char * name, int length, quint32 seed)
+{
+    quint32 h = 2166136261u ^ seed;
+    for (int i = 0; i < length; ++i) {
+        h ^= uchar(name[i]);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+/// Maps names to entry indices; Size must be a power of two
+template <int Size> struct PerfectHash {
+    quint32 seed = 0;
+    qint8 index[Size] = {};
+
+    constexpr int slot(const char * name, int length) const {
+        return int(nameHash(name, length, seed) & (Size - 1));
+    }
+    /// The index of the entry that may have the given name, or -1
+    constexpr int find(const char * name, int length) const {
+        return index[slot(name, length)];
+    }
+};
+
+/// Finds a seed that maps the names of all entries to distinct slots
+template <int Size, typename Entry, int N>
+constexpr PerfectHash<Size> makePerfectHash(const Entry (&entries)[N])
+{
+    static_assert(N <= Size && Size <= 128, "the table is too small");
+    static_assert((Size & (Size - 1)) == 0, "the size must be a power of two");
+    PerfectHash<Size> h;
+    for (quint32 seed = 1; ; ++seed) {
+        h.seed = seed;
+        for (auto & s : h.index) s = -1;
+        bool distinct = true;
+        for (int i = 0; i < N && distinct; ++i) {
+            int const s = h.slot(entries[i].name, nameLength(entries[i].name));
+            if (h.index[s] >= 0) distinct = false;
+            else h.index[s] = qint8(i);
+        }
+        if (distinct) return h;
+    }
+}
+
+#endif // FL2UI_PERFECTHASH_H
@@ -0,0 +1,275 @@
+// This file is derived from the following FLTK source file:
+// fluid/file.cxx
+// It is provided under the terms of the FLTK License, which
+// gives you some rights in addition to LGPL v.2
+
+#include "read.h"
+#include "scan.h"
+#include <QFile>
+#include <cstring>
+
+static bool isBrace(char c)
+{
+    return c == '{' || c == '}';
+}
+
+static int hexdigit(char c)
+{
+    if (c >= '0' && c <= '9') return c-'0';
+    if (c >= 'A' && c <= 'Z') return c-'A'+10;
+    if (c >= 'a' && c <= 'z') return c-'a'+10;
+    return 20;
+}
+
+/// Length of the UTF-8 sequence given its lead byte
+static int utf8Length(uchar c)
+{
+    if (c < 0xC0) return 1;
+    if (c < 0xE0) return 2;
+    if (c < 0xF0) return 3;
+    return 4;
+}
+
+static void appendUtf8(QByteArray & out, int c)
+{
+    if (c < 0x80) {
+        out.append(char(c));
+    }
+    else if (c < 0x800) {
+        out.append(char(0xC0 | (c >> 6)));
+        out.append(char(0x80 | (c & 0x3F)));
+    }
+    else {
+        out.append(char(0xE0 | (c >> 12)));
+        out.append(char(0x80 | ((c >> 6) & 0x3F)));
+        out.append(char(0x80 | (c & 0x3F)));
+    }
+}
+
+/// Decodes the escape sequence following a backslash
+static void readQuoted(const char *& p, const char * end, QByteArray & out)
+{
+    if (p == end) return;
+    int c = uchar(*p++);
+    switch (c) {
+    case '\n': return;
+    case 'a' : c = '\a'; break;
+    case 'b' : c = '\b'; break;
+    case 'f' : c = '\f'; break;
+    case 'n' : c = '\n'; break;
+    case 'r' : c = '\r'; break;
+    case 't' : c = '\t'; break;
+    case 'v' : c = '\v'; break;
+    case 'x' : {
+        // read hex
+        c = 0;
+        for (int x = 0; x < 3; x++) {
+            if (p == end) break;
+            int d = hexdigit(*p);
+            if (d > 15) break;
+            ++p;
+            c = (c << 4) + d;
+        }
+        break;
+    }
+    default:
+        if (c >= 0x80) {
+            // a quoted multibyte character stands for itself
+            int n = qMin(utf8Length(uchar(c)), int(end - p) + 1);
+            out.append(p - 1, n);
+            p += n - 1;
+            return;
+        }
+        // read octal
+        if (c<'0' || c>'7') break;
+        c -= '0';
+        for (int x=0; x<2; x++) {
+            if (p == end) break;
+            int d = hexdigit(*p);
+            if (d > 7) break;
+            ++p;
+            c = (c << 3) + d;
+        }
+        break;
+    }
+    if (c) appendUtf8(out, c);
+}
+
+bool Source::open(QFile & file)
+{
+    if (file.size() > 0) {
+        if (auto map = file.map(0, file.size())) {
+            m_data = reinterpret_cast<const char *>(map);
+            m_size = int(file.size());
+            return true;
+        }
+    }
+    return read(file);
+}
+
+bool Source::read(QIODevice & dev)
+{
+    m_buffer = dev.readAll();
+    m_data = m_buffer.constData();
+    m_size = m_buffer.size();
+    return dev.atEnd();
+}
+
+int Lexer::charLength(int pos) const
+{
+    return qMin(utf8Length(uchar(m_data[pos])), m_size - pos);
+}
+
+/// Length of the whitespace character at pos, or zero if there's none
+int Lexer::spaceLength(int pos) const
+{
+    uchar c = m_data[pos];
+    if (c < 0x80)
+        return (c == ' ' || (c >= '\t' && c <= '\r')) ? 1 : 0;
+    int n = charLength(pos);
+    QString ch = QString::fromUtf8(m_data + pos, n);
+    return (ch.size() == 1 && ch[0].isSpace()) ? n : 0;
+}
+
+void Lexer::skipLine()
+{
+    auto nl = static_cast<const char *>(memchr(m_data + m_pos, '\n', m_size - m_pos));
+    m_pos = nl ? int(nl - m_data) + 1 : m_size;
+}
+
+Token Lexer::next(bool readBrace)
+{
+    Token t;
+    const char * const end = m_data + m_size;
+    // Skip the whitespace
+    forever {
+        m_pos = int(scanSpace(m_data + m_pos, end) - m_data);
+        if (m_pos >= m_size) return t;
+        if (m_data[m_pos] == '#') {
+            skipLine();
+            continue;
+        }
+        int n = spaceLength(m_pos);
+        if (!n) break;
+        m_pos += n;
+    }
+    char c = m_data[m_pos];
+    if (c == '{' && ! readBrace) {
+        // Read between the braces
+        t.kind = Token::Block;
+        t.offset = ++m_pos;
+        int level = 1;
+        forever {
+            m_pos = int(scanBlock(m_data + m_pos, end, level) - m_data);
+            if (m_pos >= m_size) break;
+            c = m_data[m_pos];
+            if (c == '}') {
+                t.length = m_pos++ - t.offset;
+                return t;
+            }
+            t.escaped = true;
+            if (c == '#') {
+                skipLine();
+            }
+            else if (++m_pos < m_size) {
+                m_pos += charLength(m_pos);
+            }
+        }
+        t.length = m_pos - t.offset;
+    }
+    else if (isBrace(c)) {
+        // Read the braces themselves
+        t.kind = Token::Brace;
+        t.offset = m_pos++;
+        t.length = 1;
+    }
+    else {
+        // Read a single word, leaving the terminator in place
+        t.kind = Token::Word;
+        t.offset = m_pos;
+        forever {
+            m_pos = int(scanWordEnd(m_data + m_pos, end) - m_data);
+            if (m_pos >= m_size) break;
+            c = m_data[m_pos];
+            if (c == '\\') {
+                t.escaped = true;
+                if (++m_pos < m_size) m_pos += charLength(m_pos);
+            }
+            else if (uchar(c) >= 0x80 && ! spaceLength(m_pos)) {
+                m_pos += charLength(m_pos);
+            }
+            else {
+                break;
+            }
+        }
+        t.length = m_pos - t.offset;
+    }
+    return t;
+}
+
+QString Lexer::text(const Token & t) const
+{
+    if (t.isNull()) return QString();
+    m_materialized += t.length;
+    if (! t.escaped) return QString::fromUtf8(m_data + t.offset, t.length);
+    QByteArray const out = decode(t);
+    return QString::fromUtf8(out.constData(), out.size());
+}
+
+Text Lexer::slice(const Token & t, Arena & arena) const
+{
+    if (t.isNull()) return Text();
+    m_materialized += t.length;
+    if (! t.escaped) return Text(m_data + t.offset, t.length);
+    QByteArray const out = decode(t);
+    return Text(arena.copy(out.constData(), out.size()), out.size());
+}
+
+/// Decodes the escapes and removes the comments of a token
+QByteArray Lexer::decode(const Token & t) const
+{
+    const char * p = m_data + t.offset;
+    const char * const end = p + t.length;
+    QByteArray out;
+    out.reserve(t.length);
+    while (p < end) {
+        char c = *p++;
+        if (c == '#' && t.kind == Token::Block) {
+            auto nl = static_cast<const char *>(memchr(p, '\n', end - p));
+            p = nl ? nl + 1 : end;
+        }
+        else if (c == '\\') {
+            readQuoted(p, end, out);
+        }
+        else {
+            out.append(c);
+        }
+    }
+    return out;
+}
+
+bool Lexer::is(const Token & t, const char * str) const
+{
+    if (t.isNull()) return false;
+    if (t.escaped) return text(t) == QLatin1String(str);
+    return int(strlen(str)) == t.length && !memcmp(m_data + t.offset, str, t.length);
+}
+
+bool Lexer::is(const Token & t, char c) const
+{
+    if (t.isNull()) return false;
+    if (t.escaped) return text(t) == QLatin1Char(c);
+    return t.length == 1 && m_data[t.offset] == c;
+}
+
+bool Lexer::startsWith(const Token & t, char c) const
+{
+    if (t.isNull()) return false;
+    if (t.escaped) return text(t).startsWith(QLatin1Char(c));
+    return t.length && m_data[t.offset] == c;
+}
+
+QString readWord(Lexer & in, bool readBrace)
+{
+    return in.text(in.next(readBrace));
+}
@@ -0,0 +1,88 @@
+#ifndef FL2UI_READ_H
+#define FL2UI_READ_H
+
+#include <QByteArray>
+#include <QString>
+#include "arena.h"
+#include "fl2ui.h"
+
+class QFile;
+class QIODevice;
+
+/// A view of a single word in the source buffer
+struct Token {
+    enum Kind : quint8 { End, Word, Brace, Block };
+    int offset = 0;       ///< start of the raw text, past the opening brace of a block
+    int length = 0;       ///< length of the raw text, excluding the braces of a block
+    Kind kind = End;
+    bool escaped = false; ///< the raw text has escapes or comments and must be decoded
+    bool isNull() const { return kind == End; }
+};
+
+/// The UTF-8 input, memory-mapped when possible
+class FL2UI_EXPORT Source {
+    Q_DISABLE_COPY(Source)
+public:
+    Source() = default;
+    /// A view of a document in memory, which must outlive the source
+    Source(const char * data, int size) : m_data(data), m_size(size) {}
+    /// Maps an open file, or reads it if it can't be mapped
+    bool open(QFile & file);
+    /// Reads the entire device
+    bool read(QIODevice & dev);
+    const char * data() const { return m_data; }
+    int size() const { return m_size; }
+private:
+    QByteArray m_buffer;
+    const char * m_data = nullptr;
+    int m_size = 0;
+};
+
+/// Splits the FLUID source into words, without copying them
+class Lexer {
+public:
+    explicit Lexer(const Source & source) : Lexer(source.data(), source.size()) {}
+    Lexer(const char * data, int size) : m_data(data), m_size(size) {}
+    /// Reads the next word. A braced block is read whole unless readBrace is set.
+    Token next(bool readBrace = false);
+    /// Decodes the token into an owned string; the end token yields a null string
+    QString text(const Token & token) const;
+    /// A view of the decoded token: of the source, unless it has escapes
+    /// and is decoded into the arena
+    Text slice(const Token & token, Arena & arena) const;
+    /// Accounts for a token whose text isn't needed
+    void discard(const Token & token) { m_skipped += token.length; }
+    /// Whether the decoded token equals the given Latin-1 string
+    bool is(const Token & token, const char * str) const;
+    bool is(const Token & token, char c) const;
+    /// Whether the decoded token starts with the given character
+    bool startsWith(const Token & token, char c) const;
+    const char * data() const { return m_data; }
+    int size() const { return m_size; }
+    int pos() const { return m_pos; }
+    /// Continues reading at the given offset
+    void seek(int pos) { m_pos = pos; }
+    /// Bytes of token text that were decoded into strings
+    qint64 materializedBytes() const { return m_materialized; }
+    /// Bytes of token text that were discarded without decoding
+    qint64 skippedBytes() const { return m_skipped; }
+    /// Adds the byte counts of another lexer of the same source
+    void addCounts(const Lexer & other) {
+        m_materialized += other.m_materialized;
+        m_skipped += other.m_skipped;
+    }
+private:
+    QByteArray decode(const Token & token) const;
+    int spaceLength(int pos) const;
+    int charLength(int pos) const;
+    void skipLine();
+    const char * m_data;
+    int m_size;
+    int m_pos = 0;
+    mutable qint64 m_materialized = 0;
+    qint64 m_skipped = 0;
+};
+
+QString readWord(Lexer & in, bool readBrace = false);
+
+#endif // FL2UI_READ_H
@@ -0,0 +1,58 @@
+#include "reports.h"
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+void InventoryEmitter::startForm(const QString & name)
+{
+    m_form = name;
+    m_formClass.clear();
+    m_widgets = QJsonArray();
+}
+
+void InventoryEmitter::endForm()
+{
+    m_forms.append(QJsonObject{{ "name", m_form }, { "class", m_formClass }, { "widgets", m_widgets }});
+}
+
+void InventoryEmitter::startWidget(const QString & class_, const QString & name)
+{
+    if (m_open.isEmpty()) {
+        m_formClass = class_;
+    }
+    else {
+        // the top-level widget is the form itself
+        m_widgets.append(QJsonObject{{ "class", class_ }, { "name", name }, { "parent", m_open.last() }});
+        ++m_classes[class_];
+    }
+    m_open.append(name);
+}
+
+void InventoryEmitter::endWidget()
+{
+    m_open.removeLast();
+}
+
+void InventoryEmitter::customWidget(const QString & class_, const QString & extends, const QString & header)
+{
+    m_customWidgets.append(QJsonObject{{ "class", class_ }, { "extends", extends }, { "header", header }});
+}
+
+void InventoryEmitter::endDocument()
+{
+    QJsonObject classes;
+    for (auto i = m_classes.begin(); i != m_classes.end(); ++i) classes[i.key()] = i.value();
+    QJsonObject o;
+    o["forms"] = m_forms;
+    o["classes"] = classes;
+    o["customWidgets"] = m_customWidgets;
+    o["warnings"] = m_warnings;
+    QByteArray const data = QJsonDocument(o).toJson();
+    if (m_out.write(data) != data.size()) m_error = true;
+}
+
+void WarningsEmitter::warning(const QString & message)
+{
+    QByteArray const line = message.toUtf8() + '\n';
+    if (m_out.write(line) != line.size()) m_error = true;
+}
@@ -0,0 +1,72 @@
+#ifndef FL2UI_REPORTS_H
+#define FL2UI_REPORTS_H
+
+// Outputs that describe a conversion rather than the converted document,
+// for tracking a migration from FLTK
+
+#include <QJsonArray>
+#include <QMap>
+#include <QStringList>
+#include "emitter.h"
+
+class QIODevice;
+
+/// Writes a JSON inventory of the converted widgets: each form with its
+/// widgets and their parents, the number of widgets of each class, the
+/// custom widgets, and the number of warnings
+class InventoryEmitter : public Emitter {
+    Q_DISABLE_COPY(InventoryEmitter)
+public:
+    explicit InventoryEmitter(QIODevice & out) : m_out(out) {}
+    void startDocument() override {}
+    void startForm(const QString & name) override;
+    void endForm() override;
+    void startWidget(const QString & class_, const QString & name) override;
+    void endWidget() override;
+    void property(const QString &, const QString &, const QString &) override {}
+    void geometry(const QRect &) override {}
+    void attribute(const QString &, const QString &) override {}
+    void startItem() override {}
+    void endItem() override {}
+    void customWidget(const QString & class_, const QString & extends, const QString & header) override;
+    void warning(const QString &) override { ++m_warnings; }
+    void endDocument() override;
+    bool hasError() const override { return m_error; }
+private:
+    QIODevice & m_out;
+    QJsonArray m_forms;
+    QString m_form;             ///< the name of the current form
+    QString m_formClass;        ///< the class of its top-level widget
+    QJsonArray m_widgets;       ///< the widgets of the current form
+    QStringList m_open;         ///< the names of the open widgets, outermost first
+    QMap<QString, int> m_classes;
+    QJsonArray m_customWidgets;
+    int m_warnings = 0;
+    bool m_error = false;
+};
+
+/// Writes the warnings, one per line
+class WarningsEmitter : public Emitter {
+    Q_DISABLE_COPY(WarningsEmitter)
+public:
+    explicit WarningsEmitter(QIODevice & out) : m_out(out) {}
+    void startDocument() override {}
+    void startForm(const QString &) override {}
+    void endForm() override {}
+    void startWidget(const QString &, const QString &) override {}
+    void endWidget() override {}
+    void property(const QString &, const QString &, const QString &) override {}
+    void geometry(const QRect &) override {}
+    void attribute(const QString &, const QString &) override {}
+    void startItem() override {}
+    void endItem() override {}
+    void customWidget(const QString &, const QString &, const QString &) override {}
+    void warning(const QString & message) override;
+    void endDocument() override {}
+    bool hasError() const override { return m_error; }
+private:
+    QIODevice & m_out;
+    bool m_error = false;
+};
+
+#endif // FL2UI_REPORTS_H
@@ -0,0 +1,306 @@
+#include "scan.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FL2UI_SCAN_X86
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FL2UI_TARGET(isa)
+#else
+#define FL2UI_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+typedef unsigned int uint;
+typedef unsigned char uchar;
+
+static inline int firstBit(uint mask)
+{
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward(&i, mask);
+    return int(i);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static inline int bitCount(uint mask)
+{
+#ifdef _MSC_VER
+    int n = 0;
+    for (; mask; mask &= mask - 1) ++n;
+    return n;
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+/// Walks the braces of a chunk, given the bit masks of the braces and the
+/// stop characters. Returns the offset of the closing brace or the first
+/// stop, or -1 if the chunk was passed through.
+static inline int walkBraces(uint open, uint close, uint stop, int & level)
+{
+    if (stop) {
+        uint const before = (stop & (~stop + 1)) - 1;
+        open &= before;
+        close &= before;
+    }
+    int const closeCount = bitCount(close);
+    if (level > closeCount) {
+        // the block can't end within this chunk
+        level += bitCount(open) - closeCount;
+    }
+    else {
+        for (uint braces = open | close; braces; braces &= braces - 1) {
+            int i = firstBit(braces);
+            if (open & (1u << i)) ++level;
+            else if (! --level) return i;
+        }
+    }
+    return stop ? firstBit(stop) : -1;
+}
+
+static inline bool isSpaceByte(uchar c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+//
+// Scalar
+//
+
+static const char * spaceScalar(const char * p, const char * end)
+{
+    while (p < end && isSpaceByte(*p)) ++p;
+    return p;
+}
+
+static const char * wordEndScalar(const char * p, const char * end)
+{
+    for (; p < end; ++p) {
+        uchar c = *p;
+        if (isSpaceByte(c) || c == '{' || c == '}' || c == '#' || c == '\\' || c >= 0x80)
+            break;
+    }
+    return p;
+}
+
+static const char * blockScalar(const char * p, const char * end, int & level)
+{
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c == '#' || c == '\\') break;
+        if (c == '{') ++level;
+        else if (c == '}' && ! --level) break;
+    }
+    return p;
+}
+
+#ifdef FL2UI_SCAN_X86
+
+//
+// SSE2, 16 bytes at a time
+//
+
+FL2UI_TARGET("sse2")
+static inline __m128i spaceMask128(__m128i x)
+{
+    __m128i const ctl = _mm_subs_epu8(_mm_sub_epi8(x, _mm_set1_epi8('\t')), _mm_set1_epi8('\r' - '\t'));
+    return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                        _mm_cmpeq_epi8(ctl, _mm_setzero_si128()));
+}
+
+FL2UI_TARGET("sse2")
+static const char * spaceSse2(const char * p, const char * end)
+{
+    for (; end - p >= 16; p += 16) {
+        __m128i const x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        uint const mask = uint(_mm_movemask_epi8(spaceMask128(x))) ^ 0xFFFFu;
+        if (mask) return p + firstBit(mask);
+    }
+    return spaceScalar(p, end);
+}
+
+FL2UI_TARGET("sse2")
+static const char * wordEndSse2(const char * p, const char * end)
+{
+    for (; end - p >= 16; p += 16) {
+        __m128i const x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i const braces = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('{')),
+                                            _mm_cmpeq_epi8(x, _mm_set1_epi8('}')));
+        __m128i const marks = _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('#')),
+                                           _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')));
+        uint const mask = uint(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(braces, marks), spaceMask128(x))))
+                | uint(_mm_movemask_epi8(x));
+        if (mask) return p + firstBit(mask);
+    }
+    return wordEndScalar(p, end);
+}
+
+FL2UI_TARGET("sse2")
+static const char * blockSse2(const char * p, const char * end, int & level)
+{
+    for (; end - p >= 16; p += 16) {
+        __m128i const x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        uint const open = uint(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('{'))));
+        uint const close = uint(_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8('}'))));
+        uint const stop = uint(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('#')),
+                                                              _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')))));
+        if (! (open | close | stop)) continue;
+        int const i = walkBraces(open, close, stop, level);
+        if (i >= 0) return p + i;
+    }
+    return blockScalar(p, end, level);
+}
+
+//
+// AVX2, 32 bytes at a time
+//
+
+FL2UI_TARGET("avx2")
+static inline __m256i spaceMask256(__m256i x)
+{
+    __m256i const ctl = _mm256_subs_epu8(_mm256_sub_epi8(x, _mm256_set1_epi8('\t')), _mm256_set1_epi8('\r' - '\t'));
+    return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                           _mm256_cmpeq_epi8(ctl, _mm256_setzero_si256()));
+}
+
+FL2UI_TARGET("avx2")
+static const char * spaceAvx2(const char * p, const char * end)
+{
+    for (; end - p >= 32; p += 32) {
+        __m256i const x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        uint const mask = ~uint(_mm256_movemask_epi8(spaceMask256(x)));
+        if (mask) return p + firstBit(mask);
+    }
+    return spaceScalar(p, end);
+}
+
+FL2UI_TARGET("avx2")
+static const char * wordEndAvx2(const char * p, const char * end)
+{
+    for (; end - p >= 32; p += 32) {
+        __m256i const x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        __m256i const braces = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('{')),
+                                               _mm256_cmpeq_epi8(x, _mm256_set1_epi8('}')));
+        __m256i const marks = _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('#')),
+                                              _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')));
+        uint const mask = uint(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(braces, marks), spaceMask256(x))))
+                | uint(_mm256_movemask_epi8(x));
+        if (mask) return p + firstBit(mask);
+    }
+    return wordEndScalar(p, end);
+}
+
+FL2UI_TARGET("avx2")
+static const char * blockAvx2(const char * p, const char * end, int & level)
+{
+    for (; end - p >= 32; p += 32) {
+        __m256i const x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        uint const open = uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('{'))));
+        uint const close = uint(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('}'))));
+        uint const stop = uint(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('#')),
+                                                                    _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')))));
+        if (! (open | close | stop)) continue;
+        int const i = walkBraces(open, close, stop, level);
+        if (i >= 0) return p + i;
+    }
+    return blockScalar(p, end, level);
+}
+
+static bool cpuHasSse2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return info[3] & (1 << 26);
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    bool const osxsave = info[2] & (1 << 27);
+    if (! osxsave || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // FL2UI_SCAN_X86
+
+struct Scanner {
+    ScanLevel level;
+    const char * (*space)(const char *, const char *);
+    const char * (*wordEnd)(const char *, const char *);
+    const char * (*block)(const char *, const char *, int &);
+};
+
+static const Scanner scanners[] = {
+    { ScanScalar, spaceScalar, wordEndScalar, blockScalar },
+#ifdef FL2UI_SCAN_X86
+    { ScanSSE2, spaceSse2, wordEndSse2, blockSse2 },
+    { ScanAVX2, spaceAvx2, wordEndAvx2, blockAvx2 },
+#endif
+};
+
+static ScanLevel detect()
+{
+#ifdef FL2UI_SCAN_X86
+#ifndef _MSC_VER
+    __builtin_cpu_init();
+#endif
+    if (cpuHasAvx2()) return ScanAVX2;
+    if (cpuHasSse2()) return ScanSSE2;
+#endif
+    return ScanScalar;
+}
+
+static const ScanLevel supported = detect();
+static const Scanner * scanner = &scanners[supported];
+
+ScanLevel scanSupported()
+{
+    return supported;
+}
+
+void scanSelect(ScanLevel level)
+{
+    scanner = &scanners[level < supported ? level : supported];
+}
+
+ScanLevel scanSelected()
+{
+    return scanner->level;
+}
+
+const char * scanLevelName(ScanLevel level)
+{
+    switch (level) {
+    case ScanSSE2: return "SSE2";
+    case ScanAVX2: return "AVX2";
+    default: return "scalar";
+    }
+}
+
+const char * scanSpace(const char * p, const char * end)
+{
+    return scanner->space(p, end);
+}
+
+const char * scanWordEnd(const char * p, const char * end)
+{
+    return scanner->wordEnd(p, end);
+}
+
+const char * scanBlock(const char * p, const char * end, int & level)
+{
+    return scanner->block(p, end, level);
+}
@@ -0,0 +1,26 @@
+#ifndef FL2UI_SCAN_H
+#define FL2UI_SCAN_H
+
+// Vectorized searches over the source buffer. The implementation is chosen
+// at runtime from the widest instruction set the CPU supports. Each search
+// returns end when nothing is found.
+
+enum ScanLevel { ScanScalar, ScanSSE2, ScanAVX2 };
+
+/// The widest implementation supported by this CPU
+ScanLevel scanSupported();
+/// Selects an implementation; levels that aren't supported are clamped
+void scanSelect(ScanLevel level);
+ScanLevel scanSelected();
+const char * scanLevelName(ScanLevel level);
+
+/// Finds the first byte that isn't ASCII whitespace
+const char * scanSpace(const char * p, const char * end);
+/// Finds the first byte that may end a word: ASCII whitespace, a brace,
+/// '#', '\\' or a non-ASCII byte
+const char * scanWordEnd(const char * p, const char * end);
+/// Tracks the brace level through a block. Stops at the brace that brings
+/// the level to zero, or at the first '#' or '\\'.
+const char * scanBlock(const char * p, const char * end, int & level);
+
+#endif // FL2UI_SCAN_H
@@ -0,0 +1,201 @@
+#include "setupui.h"
+#include <QIODevice>
+#include <QRect>
+#include <QTextStream>
+#include "fl2ui.h"
+
+/// A C++ string literal of the text's UTF-8 bytes, escaped as uic does:
+/// a line break also breaks the literal, and carriage returns are dropped
+static QString literal(const QString & text)
+{
+    QString rv = "\"";
+    for (char const ch : text.toUtf8()) {
+        uchar const c = uchar(ch);
+        if (c == '\\' || c == '"')
+            rv += '\\' + QString(QChar(c));
+        else if (c == '\n')
+            rv += "\\n\"\n\"";
+        else if (c >= 0x80)
+            rv += QString("\\%1").arg(uint(c), 3, 8, QChar('0'));
+        else if (c != '\r')
+            rv += QChar(c);
+    }
+    return rv + '"';
+}
+
+/// The name of the property's setter
+static QString setter(const QString & property)
+{
+    return "set" + property.left(1).toUpper() + property.mid(1);
+}
+
+QString SetupUiEmitter::translate(const QString & text) const
+{
+    if (text.isEmpty()) return "QString()";
+    return QString("QCoreApplication::translate(%1, %2, nullptr)")
+            .arg(literal(m_forms.last().name), literal(text));
+}
+
+void SetupUiEmitter::startForm(const QString & name)
+{
+    m_forms.append(Form());
+    m_forms.last().name = name;
+}
+
+void SetupUiEmitter::startWidget(const QString & class_, const QString & name)
+{
+    Form & f = m_forms.last();
+    m_classes.insert(class_);
+    if (m_widgets.isEmpty()) {
+        f.class_ = class_;
+        f.widget = name;
+        f.setup << QString("if (%1->objectName().isEmpty())").arg(name)
+                << QString("    %1->setObjectName(QString::fromUtf8(%2));").arg(name, literal(name));
+    }
+    else {
+        // tab pages have no parent until they're added to the tab widget
+        Widget const & parent = m_widgets.last();
+        bool const page = parent.class_ == "QTabWidget";
+        f.members << QString("%1 *%2;").arg(class_, name);
+        f.setup << QString("%1 = new %2(%3);").arg(name, class_, page ? QString() : parent.name)
+                << QString("%1->setObjectName(QString::fromUtf8(%2));").arg(name, literal(name));
+    }
+    m_widgets.append(Widget());
+    Widget & w = m_widgets.last();
+    w.class_ = class_;
+    w.name = name;
+    w.itemsAt = f.setup.size() - 1;
+    w.itemTextsAt = f.retranslate.size();
+}
+
+void SetupUiEmitter::endWidget()
+{
+    Widget const w = m_widgets.takeLast();
+    if (m_widgets.isEmpty() || m_widgets.last().class_ != "QTabWidget") return;
+    Form & f = m_forms.last();
+    QString const & tabs = m_widgets.last().name;
+    f.setup << QString("%1->addTab(%2, QString());").arg(tabs, w.name);
+    // uic gives a page without a title a default one
+    f.retranslate << QString("%1->setTabText(%1->indexOf(%2), %3);")
+                     .arg(tabs, w.name, translate(w.title.isEmpty() ? QString("Page") : w.title));
+}
+
+void SetupUiEmitter::property(const QString & name, const QString & type, const QString & value)
+{
+    Form & f = m_forms.last();
+    Widget & w = m_widgets.last();
+    if (m_inItem) {
+        if (name == "text")
+            f.retranslate.insert(w.itemTextsAt + w.itemTexts++, QString("%1->setItemText(%2, %3);")
+                                 .arg(w.name).arg(w.items - 1).arg(translate(value)));
+        return;
+    }
+    QString argument = value;
+    if (type == "string") {
+        f.retranslate << QString("%1->%2(%3);").arg(w.name, setter(name), translate(value));
+        if (m_widgets.size() == 1) f.retranslated = true;
+        return;
+    }
+    else if (type == "int") {
+        argument = QString::number(value.toInt());
+    }
+    else if (type == "double") {
+        argument = QString::number(value.toDouble(), 'f', 15);
+    }
+    f.setup << QString("%1->%2(%3);").arg(w.name, setter(name), argument);
+}
+
+void SetupUiEmitter::geometry(const QRect & r)
+{
+    Form & f = m_forms.last();
+    QString const & name = m_widgets.last().name;
+    // the top-level widget is only sized; the window manager places it
+    if (m_widgets.size() == 1)
+        f.setup << QString("%1->resize(%2, %3);").arg(name).arg(r.width()).arg(r.height());
+    else
+        f.setup << QString("%1->setGeometry(QRect(%2, %3, %4, %5));")
+                   .arg(name).arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
+}
+
+void SetupUiEmitter::attribute(const QString & name, const QString & value)
+{
+    if (name == "title") m_widgets.last().title = value;
+}
+
+void SetupUiEmitter::startItem()
+{
+    Form & f = m_forms.last();
+    Widget & w = m_widgets.last();
+    // uic adds the items before it names the widget, and sets their texts
+    // ahead of the widget's own, followed by an empty line
+    if (! w.items) f.retranslate.insert(w.itemTextsAt, QString());
+    f.setup.insert(w.itemsAt + w.items, QString("%1->addItem(QString());").arg(w.name));
+    ++w.items;
+    m_inItem = true;
+}
+
+void SetupUiEmitter::endItem()
+{
+    m_inItem = false;
+}
+
+void SetupUiEmitter::customWidget(const QString & class_, const QString &, const QString & header)
+{
+    m_headers[class_] = header;
+}
+
+void SetupUiEmitter::endDocument()
+{
+    QString text;
+    QTextStream str(&text);
+    QString guard = "UI_" + (m_forms.isEmpty() ? QString("FORM") : m_forms.first().name.toUpper()) + "_H";
+    for (auto & ch : guard)
+        if (! ch.isLetterOrNumber()) ch = '_';
+
+    str << "/********************************************************************************\n"
+        << "** Form generated from reading a FLUID file by fl2ui " FL2UI_VERSION "\n"
+        << "**\n"
+        << "** WARNING! All changes made in this file will be lost when recompiling UI file!\n"
+        << "********************************************************************************/\n\n"
+        << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+
+    // uic includes the header of every custom widget declared, used or not
+    QStringList includes;
+    includes << "QtCore/QVariant" << "QtWidgets/QApplication";
+    for (auto const & class_ : m_classes)
+        if (! m_headers.contains(class_)) includes << "QtWidgets/" + class_;
+    includes.sort();
+    QStringList headers = m_headers.values();
+    headers.sort();
+    headers.removeDuplicates();
+    for (auto const & include : includes) str << "#include <" << include << ">\n";
+    for (auto const & header : headers) str << "#include \"" << header << "\"\n";
+    str << "\nQT_BEGIN_NAMESPACE\n\n";
+
+    for (auto const & f : m_forms) {
+        str << "class Ui_" << f.name << "\n{\npublic:\n";
+        for (auto const & member : f.members) str << "    " << member << "\n";
+        str << "\n    void setupUi(" << f.class_ << " *" << f.widget << ")\n    {\n";
+        for (auto const & line : f.setup) str << "        " << line << "\n";
+        str << "\n        retranslateUi(" << f.widget << ");\n\n"
+            << "        QMetaObject::connectSlotsByName(" << f.widget << ");\n"
+            << "    } // setupUi\n\n"
+            << "    void retranslateUi(" << f.class_ << " *" << f.widget << ")\n    {\n";
+        for (auto const & line : f.retranslate) str << (line.isEmpty() ? "" : "        ") << line << "\n";
+        // uic marks the widget as used when nothing else refers to it
+        if (! f.retranslated) str << "        (void)" << f.widget << ";\n";
+        str << "    } // retranslateUi\n\n};\n\n";
+    }
+
+    if (! m_forms.isEmpty()) {
+        str << "namespace Ui {\n";
+        for (auto const & f : m_forms)
+            str << "    class " << f.name << ": public Ui_" << f.name << " {};\n";
+        str << "} // namespace Ui\n\n";
+    }
+    str << "QT_END_NAMESPACE\n\n#endif // " << guard << "\n";
+    str.flush();
+
+    QByteArray const data = text.toUtf8();
+    if (m_out.write(data) != data.size()) m_error = true;
+}
@@ -0,0 +1,63 @@
+#ifndef FL2UI_SETUPUI_H
+#define FL2UI_SETUPUI_H
+
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+#include "emitter.h"
+
+class QIODevice;
+
+/// Writes a C++ header with a Ui_ class for each form, with the setupUi()
+/// and retranslateUi() functions uic 5 generates from the .ui document of
+/// the same conversion; parsebench compares the two. The header is written
+/// at the end of the document.
+class SetupUiEmitter : public Emitter {
+    Q_DISABLE_COPY(SetupUiEmitter)
+public:
+    explicit SetupUiEmitter(QIODevice & out) : m_out(out) {}
+    void startDocument() override {}
+    void startForm(const QString & name) override;
+    void endForm() override {}
+    void startWidget(const QString & class_, const QString & name) override;
+    void endWidget() override;
+    void property(const QString & name, const QString & type, const QString & value) override;
+    void geometry(const QRect & r) override;
+    void attribute(const QString & name, const QString & value) override;
+    void startItem() override;
+    void endItem() override;
+    void customWidget(const QString & class_, const QString & extends, const QString & header) override;
+    void warning(const QString &) override {}
+    void endDocument() override;
+    bool hasError() const override { return m_error; }
+private:
+    struct Widget {
+        QString class_;
+        QString name;
+        QString title;      ///< of its tab
+        int items = 0;
+        int itemTexts = 0;      ///< the items with a text
+        int itemsAt = 0;        ///< where its items go in the setup code
+        int itemTextsAt = 0;    ///< where their texts go in the retranslation code
+    };
+    struct Form {
+        QString name;
+        QString class_;     ///< of the top-level widget
+        QString widget;     ///< the name of the top-level widget
+        QStringList members;
+        QStringList setup;
+        QStringList retranslate;
+        bool retranslated = false;  ///< the retranslation code refers to the widget
+    };
+    QString translate(const QString & text) const;
+    QIODevice & m_out;
+    QVector<Form> m_forms;
+    QVector<Widget> m_widgets;      ///< the open widgets, outermost first
+    bool m_inItem = false;
+    QSet<QString> m_classes;        ///< the widget classes used
+    QMap<QString, QString> m_headers;   ///< the headers of the custom widgets
+    bool m_error = false;
+};
+
+#endif // FL2UI_SETUPUI_H
@@ -0,0 +1,41 @@
+#include "sink.h"
+#include <QElapsedTimer>
+
+Sink::Sink(QIODevice & target, QByteArray * buffer) : m_target(target), m_reuse(buffer)
+{
+    if (m_reuse) m_buffer.swap(*m_reuse);
+    m_buffer.reserve(Capacity);
+    open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+}
+
+Sink::~Sink()
+{
+    drain();
+    if (m_reuse) m_buffer.swap(*m_reuse);
+}
+
+bool Sink::writeTarget(const char * data, qint64 len)
+{
+    if (m_failed) return false;
+    QElapsedTimer timer;
+    if (m_nsecs) timer.start();
+    m_failed = m_target.write(data, len) != len;
+    if (m_nsecs) *m_nsecs += timer.nsecsElapsed();
+    return ! m_failed;
+}
+
+bool Sink::drain()
+{
+    bool const ok = m_buffer.isEmpty() ? ! m_failed : writeTarget(m_buffer.constData(), m_buffer.size());
+    // the reserved capacity is kept
+    m_buffer.resize(0);
+    return ok;
+}
+
+qint64 Sink::writeData(const char * data, qint64 len)
+{
+    if (m_buffer.size() + len > Capacity && ! drain()) return -1;
+    if (len >= Capacity) return writeTarget(data, len) ? len : -1;
+    m_buffer.append(data, int(len));
+    return len;
+}
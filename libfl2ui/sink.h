@@ -0,0 +1,34 @@
+#ifndef FL2UI_SINK_H
+#define FL2UI_SINK_H
+
+#include <QIODevice>
+#include <QByteArray>
+
+/// Gathers small writes into fixed-size chunks before passing them to the
+/// target device, so that the output is streamed without being held whole
+class Sink : public QIODevice {
+    Q_DISABLE_COPY(Sink)
+public:
+    enum { Capacity = 64 * 1024 };
+    /// Gathers the chunks in the given buffer, if any, which keeps its
+    /// capacity for the next sink
+    explicit Sink(QIODevice & target, QByteArray * buffer = nullptr);
+    ~Sink();
+    /// Writes the buffered bytes to the target; false if any write failed
+    bool drain();
+    bool isSequential() const override { return true; }
+    /// Accumulates the time spent writing to the target
+    void setTimer(qint64 * nsecs) { m_nsecs = nsecs; }
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char * data, qint64 len) override;
+private:
+    bool writeTarget(const char * data, qint64 len);
+    QIODevice & m_target;
+    QByteArray m_buffer;
+    QByteArray * m_reuse;
+    bool m_failed = false;
+    qint64 * m_nsecs = nullptr;
+};
+
+#endif // FL2UI_SINK_H
@@ -0,0 +1,104 @@
+#include "stats.h"
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+static const char * const phaseNames[Stats::PhaseCount] = { "read", "tokenize", "parse", "generate", "emit" };
+
+void Stats::add(const Stats & other)
+{
+    for (int i = 0; i < PhaseCount; ++i) nsecs[i] += other.nsecs[i];
+    files += other.files;
+    bytes += other.bytes;
+    tokens += other.tokens;
+    materializedBytes += other.materializedBytes;
+    skippedBytes += other.skippedBytes;
+    unknownElements += other.unknownElements;
+    warnings += other.warnings;
+    cacheHits += other.cacheHits;
+    cacheMisses += other.cacheMisses;
+    for (auto i = other.widgets.begin(); i != other.widgets.end(); ++i)
+        widgets[i.key()] += i.value();
+}
+
+static double perSecond(qint64 count, qint64 nsecs)
+{
+    return nsecs > 0 ? count * 1e9 / nsecs : 0.0;
+}
+
+QString Stats::toText(qint64 wallNsecs) const
+{
+    QString rv;
+    QTextStream str(&rv);
+    qint64 total = 0;
+    for (auto n : nsecs) total += n;
+    str << "Files: " << files << ", " << bytes << " bytes, " << tokens << " tokens\n";
+    str << "Wall time: " << wallNsecs / 1e6 << " ms, "
+        << perSecond(bytes, wallNsecs) / 1e6 << " MB/s, "
+        << perSecond(tokens, wallNsecs) << " tokens/s\n";
+    str << "Materialized " << materializedBytes << " bytes, skipped " << skippedBytes << " bytes\n";
+    for (int i = 0; i < PhaseCount; ++i) {
+        str << "  " << QString(phaseNames[i]).leftJustified(9) << nsecs[i] / 1e6 << " ms";
+        if (total) str << " (" << qRound(100.0 * nsecs[i] / total) << "%)";
+        str << "\n";
+    }
+    str << "Widgets:\n";
+    for (auto i = widgets.begin(); i != widgets.end(); ++i)
+        str << "  " << i.key().leftJustified(17) << i.value() << "\n";
+    str << "Unknown elements: " << unknownElements << "\n";
+    str << "Warnings: " << warnings << "\n";
+    if (cacheHits || cacheMisses)
+        str << "Cache: " << cacheHits << " hits, " << cacheMisses << " misses\n";
+    qint64 const rss = peakRss();
+    if (rss >= 0) str << "Peak RSS: " << rss / 1024 << " KiB\n";
+    str.flush();
+    return rv;
+}
+
+QByteArray Stats::toJson(qint64 wallNsecs) const
+{
+    QJsonObject phases;
+    for (int i = 0; i < PhaseCount; ++i) phases[phaseNames[i]] = nsecs[i] / 1e9;
+    QJsonObject widgetCounts;
+    for (auto i = widgets.begin(); i != widgets.end(); ++i) widgetCounts[i.key()] = double(i.value());
+    QJsonObject o;
+    o["files"] = double(files);
+    o["bytes"] = double(bytes);
+    o["tokens"] = double(tokens);
+    o["materializedBytes"] = double(materializedBytes);
+    o["skippedBytes"] = double(skippedBytes);
+    o["wallSeconds"] = wallNsecs / 1e9;
+    o["bytesPerSecond"] = perSecond(bytes, wallNsecs);
+    o["tokensPerSecond"] = perSecond(tokens, wallNsecs);
+    o["phaseSeconds"] = phases;
+    o["widgets"] = widgetCounts;
+    o["unknownElements"] = double(unknownElements);
+    o["warnings"] = double(warnings);
+    o["cacheHits"] = double(cacheHits);
+    o["cacheMisses"] = double(cacheMisses);
+    o["peakRssBytes"] = double(peakRss());
+    return QJsonDocument(o).toJson();
+}
+
+qint64 peakRss()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (! GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return -1;
+    return qint64(pmc.PeakWorkingSetSize);
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru)) return -1;
+#ifdef Q_OS_MAC
+    return qint64(ru.ru_maxrss);
+#else
+    return qint64(ru.ru_maxrss) * 1024;
+#endif
+#endif
+}
@@ -0,0 +1,41 @@
+#ifndef FL2UI_STATS_H
+#define FL2UI_STATS_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include "fl2ui.h"
+
+/// Phase timings and counters of one or more conversions
+struct FL2UI_EXPORT Stats {
+    enum Phase {
+        Read,       ///< opening or reading the input
+        Tokenize,   ///< splitting the input into words
+        Parse,      ///< the parser handlers, building the widget tree
+        Generate,   ///< walking the widget tree to build the XML
+        Emit,       ///< writing the encoded output to the device
+        PhaseCount
+    };
+    qint64 nsecs[PhaseCount] = {};
+    qint64 files = 0;
+    qint64 bytes = 0;
+    qint64 tokens = 0;
+    qint64 materializedBytes = 0;   ///< of the words decoded into text
+    qint64 skippedBytes = 0;        ///< of the words skipped without decoding
+    qint64 unknownElements = 0;
+    qint64 warnings = 0;
+    qint64 cacheHits = 0;
+    qint64 cacheMisses = 0;
+    QMap<QString, qint64> widgets;  ///< converted widgets by FLUID class
+
+    /// Accumulates the stats of another conversion
+    void add(const Stats & other);
+    /// A human-readable report; wallNsecs is the elapsed time of the run
+    QString toText(qint64 wallNsecs) const;
+    QByteArray toJson(qint64 wallNsecs) const;
+};
+
+/// The peak resident set size of the process in bytes, or -1 if unknown
+FL2UI_EXPORT qint64 peakRss();
+
+#endif // FL2UI_STATS_H
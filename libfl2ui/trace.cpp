@@ -0,0 +1,55 @@
+#include "trace.h"
+#include <QAtomicInt>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+/// A small number that identifies the current thread in the trace
+static int threadNumber()
+{
+    static QAtomicInt counter;
+    thread_local int const number = counter.fetchAndAddRelaxed(1);
+    return number;
+}
+
+void Trace::add(const QVector<TraceEvent> & events)
+{
+    int const thread = threadNumber();
+    QMutexLocker lock(&m_mutex);
+    for (auto & track : m_tracks) {
+        if (track.thread == thread) {
+            track.events += events;
+            return;
+        }
+    }
+    m_tracks.append({ thread, events });
+}
+
+QByteArray Trace::toJson() const
+{
+    QMutexLocker lock(&m_mutex);
+    QJsonArray events;
+    for (auto const & track : m_tracks) {
+        QJsonObject meta;
+        meta["name"] = "thread_name";
+        meta["ph"] = "M";
+        meta["pid"] = 1;
+        meta["tid"] = track.thread;
+        meta["args"] = QJsonObject{{ "name", QString("thread %1").arg(track.thread) }};
+        events.append(meta);
+        for (auto const & e : track.events) {
+            QJsonObject o;
+            o["name"] = e.name;
+            o["ph"] = "X";
+            o["pid"] = 1;
+            o["tid"] = track.thread;
+            o["ts"] = e.start / 1e3;
+            o["dur"] = e.duration / 1e3;
+            if (! e.args.isEmpty()) o["args"] = e.args;
+            events.append(o);
+        }
+    }
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
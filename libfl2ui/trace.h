@@ -0,0 +1,42 @@
+#ifndef FL2UI_TRACE_H
+#define FL2UI_TRACE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <QVector>
+#include "fl2ui.h"
+
+/// A span of time on one thread
+struct TraceEvent {
+    const char * name;
+    qint64 start;           ///< nanoseconds since the trace began
+    qint64 duration;
+    QJsonObject args;
+};
+
+/// Collects spans from any number of threads and writes them in the
+/// Chrome trace event format, which Perfetto reads as well. Each thread
+/// gets its own track.
+class FL2UI_EXPORT Trace {
+    Q_DISABLE_COPY(Trace)
+public:
+    Trace() { m_clock.start(); }
+    /// Nanoseconds since the trace began
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+    /// Adds spans recorded on the current thread
+    void add(const QVector<TraceEvent> & events);
+    void add(const TraceEvent & event) { add(QVector<TraceEvent>() << event); }
+    QByteArray toJson() const;
+private:
+    struct Track {
+        int thread;
+        QVector<TraceEvent> events;
+    };
+    QElapsedTimer m_clock;
+    mutable QMutex m_mutex;
+    QVector<Track> m_tracks;
+};
+
+#endif // FL2UI_TRACE_H
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Sends conversion requests to a running `fl2ui --serve` and prints the responses.
+
+Examples:
+    # start a server on standard input and output and convert two files
+    fl2ui-client.py --spawn ./fl2ui a.fl b.fl
+    # talk to a server started with `fl2ui --serve --socket fl2ui`
+    fl2ui-client.py --socket /tmp/fl2ui a.fl
+    # send a document inline and print the .ui it converts to
+    fl2ui-client.py --spawn ./fl2ui --inline a.fl
+"""
+
+import argparse
+import json
+import os
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+
+
+def send(stream, message):
+    payload = json.dumps(message).encode('utf-8')
+    stream.write(struct.pack('>I', len(payload)) + payload)
+    stream.flush()
+
+
+def receive(stream):
+    header = stream.read(4)
+    if len(header) < 4:
+        raise EOFError('the server closed the connection')
+    size, = struct.unpack('>I', header)
+    return json.loads(stream.read(size).decode('utf-8'))
+
+
+def socket_path(name):
+    # QLocalServer puts names that aren't paths in the temporary directory
+    return name if os.path.isabs(name) else os.path.join(tempfile.gettempdir(), name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    target = parser.add_mutually_exclusive_group(required=True)
+    target.add_argument('--spawn', metavar='FL2UI', help='start FL2UI --serve and talk to it over a pipe')
+    target.add_argument('--socket', metavar='NAME', help='connect to a server listening on a local socket')
+    parser.add_argument('--inline', action='store_true', help='send the contents and print the returned .ui')
+    parser.add_argument('--recover', action='store_true', help='skip malformed widgets')
+    parser.add_argument('--shutdown', action='store_true', help='stop the server afterwards')
+    parser.add_argument('files', nargs='*', help='the .fl files to convert')
+    args = parser.parse_args()
+
+    if args.spawn:
+        server = subprocess.Popen([args.spawn, '--serve'], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        writer, reader = server.stdin, server.stdout
+    else:
+        server = None
+        conn = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        conn.connect(socket_path(args.socket))
+        writer = reader = conn.makefile('rwb')
+
+    # send everything first, so that the server converts the files concurrently
+    for i, path in enumerate(args.files):
+        request = {'id': i, 'options': {'recover': args.recover}}
+        if args.inline:
+            with open(path, encoding='utf-8', errors='surrogateescape') as f:
+                request['content'] = f.read()
+        else:
+            request['input'] = os.path.abspath(path)
+            request['output'] = os.path.splitext(os.path.abspath(path))[0] + '.ui'
+        send(writer, request)
+
+    failed = 0
+    for _ in args.files:
+        response = receive(reader)
+        path = args.files[response.get('id', 0)]
+        status = response.get('status')
+        failed += status not in (0, 5)
+        print('%s: status %s' % (path, status))
+        sys.stdout.write(response.get('diagnostics', ''))
+        if 'ui' in response:
+            sys.stdout.write(response['ui'])
+
+    if args.shutdown or server:
+        send(writer, {'command': 'shutdown'})
+        receive(reader)
+    if server:
+        server.stdin.close()
+        server.wait()
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
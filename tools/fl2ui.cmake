@@ -0,0 +1,56 @@
+# fl2ui_wrap(<variable> <file.fl>...)
+#
+# Converts each FLUID file to a .ui file in the current binary directory and
+# appends the paths of the .ui files to <variable>, for qt5_wrap_ui() or a
+# target with AUTOUIC:
+#
+#     include(fl2ui.cmake)
+#     fl2ui_wrap(ui_files dialog.fl)
+#     qt5_wrap_ui(ui_headers ${ui_files})
+#     add_executable(app main.cpp ${ui_headers})
+#
+# The converter is the fl2ui target when the project builds it, and the
+# FL2UI_EXECUTABLE program otherwise. Each conversion writes a depfile, so
+# the output is only remade when its input or the converter changes; the
+# Makefile generators read depfiles from CMake 3.20, Ninja always does.
+# --if-changed keeps uic from running again for outputs that didn't change.
+
+if(TARGET fl2ui)
+    set(FL2UI_EXECUTABLE $<TARGET_FILE:fl2ui>)
+    set(_fl2ui_depends fl2ui)
+else()
+    find_program(FL2UI_EXECUTABLE fl2ui)
+    set(_fl2ui_depends ${FL2UI_EXECUTABLE})
+endif()
+
+if(CMAKE_GENERATOR MATCHES "Ninja"
+   OR (CMAKE_GENERATOR MATCHES "Makefiles" AND NOT CMAKE_VERSION VERSION_LESS 3.20))
+    set(_fl2ui_depfiles TRUE)
+else()
+    set(_fl2ui_depfiles FALSE)
+endif()
+
+function(fl2ui_wrap variable)
+    set(outputs ${${variable}})
+    foreach(fl ${ARGN})
+        get_filename_component(input ${fl} ABSOLUTE)
+        get_filename_component(name ${fl} NAME_WE)
+        set(output ${CMAKE_CURRENT_BINARY_DIR}/${name}.ui)
+        if(_fl2ui_depfiles)
+            add_custom_command(OUTPUT ${output}
+                COMMAND ${FL2UI_EXECUTABLE} --if-changed --depfile ${output}.d ${input} ${output}
+                DEPENDS ${input} ${_fl2ui_depends}
+                DEPFILE ${output}.d
+                COMMENT "Converting ${fl}"
+                VERBATIM)
+        else()
+            add_custom_command(OUTPUT ${output}
+                COMMAND ${FL2UI_EXECUTABLE} --if-changed ${input} ${output}
+                DEPENDS ${input} ${_fl2ui_depends}
+                COMMENT "Converting ${fl}"
+                VERBATIM)
+        endif()
+        list(APPEND outputs ${output})
+    endforeach()
+    set(${variable} ${outputs} PARENT_SCOPE)
+endfunction()